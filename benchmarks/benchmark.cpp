@@ -0,0 +1,1702 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <QtTest>
+#include <QBuffer>
+#include <QActionGroup>
+#include <QMenu>
+#include <QWidgetAction>
+#include <QQmlEngine>
+#include <QQmlComponent>
+#include <QQmlProperty>
+#include <QQuickWindow>
+#include <QQuickItem>
+
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "platformagnosticmenus.hpp"
+#include "platformagnosticactionstatequeue.hpp"
+#include "platformagnosticbasicmenu.hpp"
+
+// Run with QT_QPA_PLATFORM=offscreen. Pass "-o results.xml,xml" (or csv)
+// to get machine readable results.
+class PlatformAgnosticMenuBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void createDestroyMenu_data();
+    void createDestroyMenu();
+
+    void addActions_data();
+    void addActions();
+
+    void insertActions_data();
+    void insertActions();
+
+    void addRemoveActions_data();
+    void addRemoveActions();
+
+    void addRemoveAction_data();
+    void addRemoveAction();
+
+    void clear_data();
+    void clear();
+
+    void actions_data();
+    void actions();
+
+    void isEmpty_data();
+    void isEmpty();
+
+    void sizeHint_data();
+    void sizeHint();
+
+    void popupClose_data();
+    void popupClose();
+
+    void setIcon_data();
+    void setIcon();
+
+    void setShortcut_data();
+    void setShortcut();
+
+    void actionGroupAddRemove_data();
+    void actionGroupAddRemove();
+
+    void actionGroupRepopulate_data();
+    void actionGroupRepopulate();
+
+    void stateUpdates_data();
+    void stateUpdates();
+
+    void fromMenu();
+
+    void eventDispatch_data();
+    void eventDispatch();
+
+    void staticDispatch_data();
+    void staticDispatch();
+
+    void filter_data();
+    void filter();
+
+    void filterAfterTextChange_data();
+    void filterAfterTextChange();
+
+    void firstQuickMenu_data();
+    void firstQuickMenu();
+
+    void memoryPerAction_data();
+    void memoryPerAction();
+
+    void separatorRebuild_data();
+    void separatorRebuild();
+
+    void memoryPerSeparator_data();
+    void memoryPerSeparator();
+
+    void arenaBuildTeardown_data();
+    void arenaBuildTeardown();
+
+    void arenaFragmentation_data();
+    void arenaFragmentation();
+
+    void popupToFrame_data();
+    void popupToFrame();
+
+    void hibernationReclaimed_data();
+    void hibernationReclaimed();
+
+    void rehydrate_data();
+    void rehydrate();
+
+    void speculativeSubmenu_data();
+    void speculativeSubmenu();
+
+    void mruTouch_data();
+    void mruTouch();
+
+    void stateProviders_data();
+    void stateProviders();
+
+    void pagedPopup_data();
+    void pagedPopup();
+
+    void accountingSnapshot_data();
+    void accountingSnapshot();
+
+    void accountingLeaks();
+
+    void traceRoundTrip();
+
+    void triggerHandlers();
+
+private:
+    PlatformAgnosticMenu* createRootMenu(const QString& backend) const;
+    QList<PlatformAgnosticAction*> createActions(PlatformAgnosticMenu* menu, int count) const;
+    template<class Backend>
+    void runStaticDispatch(PlatformAgnosticMenu* menu, bool isStatic, int count) const;
+
+    static void addBackendRows();
+    static void addBackendCountRows(const QList<int>& counts = {10, 100, 10000});
+    static void flushDeferredDeletes();
+    static qint64 allocatedBytes();
+    static qint64 freeHeapBytes();
+    static void addArenaRows();
+    static void buildTree(PlatformAgnosticMenu* root, int submenuCount, int actionCount);
+    static void buildSeparatedActions(PlatformAgnosticMenu* menu, int actionCount);
+    static QObject* addHibernationState(PlatformAgnosticMenu* menu, const QString& backend);
+    static QStringList describeContent(PlatformAgnosticMenu* menu);
+
+    QQmlEngine* m_engine = nullptr;
+    QQuickWindow* m_window = nullptr;
+    QQuickItem* m_rootItem = nullptr;
+};
+
+void PlatformAgnosticMenuBenchmark::initTestCase()
+{
+    m_window = new QQuickWindow;
+    m_window->resize(640, 480);
+
+    m_engine = new QQmlEngine(this);
+
+    // QuickControls2Menu needs a parent item with an engine associated to its context
+    QQmlComponent component(m_engine);
+    component.setData("import QtQuick 2.12\nItem {}", QUrl());
+    m_rootItem = qobject_cast<QQuickItem*>(component.create());
+    QVERIFY2(m_rootItem, qPrintable(component.errorString()));
+    m_rootItem->setParentItem(m_window->contentItem());
+    m_rootItem->setSize(m_window->size());
+
+    m_window->show();
+}
+
+void PlatformAgnosticMenuBenchmark::cleanupTestCase()
+{
+    delete m_rootItem;
+    delete m_window;
+    flushDeferredDeletes();
+}
+
+PlatformAgnosticMenu* PlatformAgnosticMenuBenchmark::createRootMenu(const QString& backend) const
+{
+    if (backend == QLatin1String("widgets"))
+        return PlatformAgnosticMenu::createMenu();
+    else if (backend == QLatin1String("null"))
+        return new NullMenu;
+    else
+        return PlatformAgnosticMenu::createMenu(m_rootItem);
+}
+
+QList<PlatformAgnosticAction*> PlatformAgnosticMenuBenchmark::createActions(PlatformAgnosticMenu* menu, const int count) const
+{
+    QList<PlatformAgnosticAction*> list;
+    list.reserve(count);
+    for (int i = 0; i < count; ++i)
+        list.push_back(PlatformAgnosticAction::createAction(QStringLiteral("Action %1").arg(i), menu));
+    return list;
+}
+
+void PlatformAgnosticMenuBenchmark::addBackendRows()
+{
+    QTest::addColumn<QString>("backend");
+
+    QTest::newRow("widgets") << QStringLiteral("widgets");
+    QTest::newRow("quick") << QStringLiteral("quick");
+    // Baseline of the wrappers without Qt Widgets or Qt Quick
+    QTest::newRow("null") << QStringLiteral("null");
+}
+
+void PlatformAgnosticMenuBenchmark::addBackendCountRows(const QList<int>& counts)
+{
+    QTest::addColumn<QString>("backend");
+    QTest::addColumn<int>("count");
+
+    for (const auto backend : {QStringLiteral("widgets"), QStringLiteral("quick"), QStringLiteral("null")})
+    {
+        for (const int count : counts)
+            QTest::addRow("%s/%d", qPrintable(backend), count) << backend << count;
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::flushDeferredDeletes()
+{
+    // WidgetsMenu defers the deletion of its QMenu
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+}
+
+qint64 PlatformAgnosticMenuBenchmark::allocatedBytes()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return static_cast<qint64>(mallinfo2().uordblks);
+#else
+    return -1;
+#endif
+}
+
+qint64 PlatformAgnosticMenuBenchmark::freeHeapBytes()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return static_cast<qint64>(mallinfo2().fordblks);
+#else
+    return -1;
+#endif
+}
+
+void PlatformAgnosticMenuBenchmark::addArenaRows()
+{
+    QTest::addColumn<QString>("backend");
+    QTest::addColumn<bool>("arena");
+
+    for (const auto backend : {QStringLiteral("widgets"), QStringLiteral("quick"), QStringLiteral("null")})
+    {
+        QTest::addRow("%s/heap", qPrintable(backend)) << backend << false;
+        QTest::addRow("%s/arena", qPrintable(backend)) << backend << true;
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::buildTree(PlatformAgnosticMenu *root, const int submenuCount, const int actionCount)
+{
+    for (int i = 0; i < submenuCount; ++i)
+    {
+        const auto submenu = root->addMenu(QStringLiteral("Menu %1").arg(i));
+        for (int j = 0; j < actionCount; ++j)
+            submenu->addAction(QStringLiteral("Action %1").arg(j));
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::buildSeparatedActions(PlatformAgnosticMenu *menu, const int actionCount)
+{
+    for (int i = 0; i < actionCount; ++i)
+    {
+        menu->addAction(QStringLiteral("Action %1").arg(i));
+        if (i % 10 == 9)
+            menu->addSeparator();
+    }
+}
+
+QObject* PlatformAgnosticMenuBenchmark::addHibernationState(PlatformAgnosticMenu *menu, const QString &backend)
+{
+    // The state that hibernate() has to keep, besides the text and the order
+    const auto actionList = menu->actions();
+    for (qsizetype i = 0; i < actionList.size(); i += 3)
+    {
+        actionList[i]->setCheckable(true);
+        actionList[i]->setChecked(true);
+    }
+
+    actionList.first()->setShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_H));
+
+    // Owned by the native menu, which hibernate() must not delete
+    QObject* item = nullptr;
+    if (backend == QLatin1String("widgets"))
+        item = new QWidgetAction(menu->menu());
+    else if (backend == QLatin1String("quick"))
+        item = new QQuickItem;
+    else
+        item = new QObject(menu->menu());
+
+    menu->addItem(item);
+    return item;
+}
+
+QStringList PlatformAgnosticMenuBenchmark::describeContent(PlatformAgnosticMenu *menu)
+{
+    // Creates the content, like popup() does
+    menu->sizeHint();
+
+    QStringList content;
+
+    if (const auto nativeMenu = qobject_cast<QMenu*>(menu->menu()))
+    {
+        // The separators and the items, in their place
+        const auto nativeList = nativeMenu->actions();
+        for (const auto action : nativeList)
+        {
+            if (action->isSeparator())
+                content.push_back(QStringLiteral("-"));
+            else if (qobject_cast<QWidgetAction*>(action))
+                content.push_back(QStringLiteral("item"));
+            else
+                content.push_back(action->text() + (action->isChecked() ? QStringLiteral(" *") : QString()));
+        }
+        return content;
+    }
+
+    const auto actionList = menu->actions();
+    for (const auto action : actionList)
+        content.push_back(action->text() + (action->isChecked() ? QStringLiteral(" *") : QString()));
+    return content;
+}
+
+void PlatformAgnosticMenuBenchmark::createDestroyMenu_data()
+{
+    addBackendRows();
+}
+
+void PlatformAgnosticMenuBenchmark::createDestroyMenu()
+{
+    QFETCH(QString, backend);
+
+    QBENCHMARK {
+        delete createRootMenu(backend);
+        flushDeferredDeletes();
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::addActions_data()
+{
+    addBackendCountRows();
+}
+
+void PlatformAgnosticMenuBenchmark::addActions()
+{
+    QFETCH(QString, backend);
+    QFETCH(int, count);
+
+    QBENCHMARK {
+        const auto menu = createRootMenu(backend);
+        for (int i = 0; i < count; ++i)
+            menu->addAction(QStringLiteral("Action %1").arg(i));
+        delete menu;
+        flushDeferredDeletes();
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::insertActions_data()
+{
+    addBackendCountRows();
+}
+
+void PlatformAgnosticMenuBenchmark::insertActions()
+{
+    QFETCH(QString, backend);
+    QFETCH(int, count);
+
+    QBENCHMARK {
+        const auto menu = createRootMenu(backend);
+        const auto first = menu->addAction(QStringLiteral("First"));
+        for (int i = 0; i < count; ++i)
+            menu->insertAction(first, PlatformAgnosticAction::createAction(QStringLiteral("Action %1").arg(i), menu));
+        delete menu;
+        flushDeferredDeletes();
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::addRemoveActions_data()
+{
+    addBackendCountRows();
+}
+
+void PlatformAgnosticMenuBenchmark::addRemoveActions()
+{
+    QFETCH(QString, backend);
+    QFETCH(int, count);
+
+    const auto menu = createRootMenu(backend);
+    const auto actionList = createActions(menu, count);
+
+    QBENCHMARK {
+        for (const auto action : actionList)
+            menu->addAction(action);
+        for (const auto action : actionList)
+            menu->removeAction(action);
+    }
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::addRemoveAction_data()
+{
+    addBackendRows();
+}
+
+void PlatformAgnosticMenuBenchmark::addRemoveAction()
+{
+    QFETCH(QString, backend);
+
+    // Per call cost of a single mutation, including the dispatch into the native menu
+    const auto menu = createRootMenu(backend);
+    const auto action = PlatformAgnosticAction::createAction(QStringLiteral("Action"), menu);
+
+    QBENCHMARK {
+        menu->addAction(action);
+        menu->removeAction(action);
+    }
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::clear_data()
+{
+    addBackendCountRows();
+}
+
+void PlatformAgnosticMenuBenchmark::clear()
+{
+    QFETCH(QString, backend);
+    QFETCH(int, count);
+
+    const auto menu = createRootMenu(backend);
+    const auto actionList = createActions(menu, count);
+
+    QBENCHMARK {
+        for (const auto action : actionList)
+            menu->addAction(action);
+        menu->clear();
+    }
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::actions_data()
+{
+    addBackendCountRows();
+}
+
+void PlatformAgnosticMenuBenchmark::actions()
+{
+    QFETCH(QString, backend);
+    QFETCH(int, count);
+
+    const auto menu = createRootMenu(backend);
+    for (const auto action : createActions(menu, count))
+        menu->addAction(action);
+
+    qsizetype size = 0;
+    QBENCHMARK {
+        size += menu->actions().size();
+    }
+    QVERIFY(size > 0);
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::isEmpty_data()
+{
+    addBackendCountRows();
+}
+
+void PlatformAgnosticMenuBenchmark::isEmpty()
+{
+    QFETCH(QString, backend);
+    QFETCH(int, count);
+
+    const auto menu = createRootMenu(backend);
+    const auto actionList = createActions(menu, count);
+    for (const auto action : actionList)
+        menu->addAction(action);
+
+    // Only the last action is visible, the worst case for a scan
+    for (auto i = 0; i < actionList.size() - 1; ++i)
+        actionList[i]->setVisible(false);
+
+    bool empty = true;
+    QBENCHMARK {
+        empty = menu->isEmpty();
+    }
+    QVERIFY(!empty);
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::sizeHint_data()
+{
+    addBackendCountRows({10, 100});
+}
+
+void PlatformAgnosticMenuBenchmark::sizeHint()
+{
+    QFETCH(QString, backend);
+    QFETCH(int, count);
+
+    const auto menu = createRootMenu(backend);
+    for (const auto action : createActions(menu, count))
+        menu->addAction(action);
+
+    QBENCHMARK {
+        menu->sizeHint();
+    }
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::popupClose_data()
+{
+    addBackendCountRows({10, 100});
+}
+
+void PlatformAgnosticMenuBenchmark::popupClose()
+{
+    QFETCH(QString, backend);
+    QFETCH(int, count);
+
+    const auto menu = createRootMenu(backend);
+    for (const auto action : createActions(menu, count))
+        menu->addAction(action);
+
+    const QPoint pos = m_window->mapToGlobal(QPoint{10, 10});
+
+    QBENCHMARK {
+        menu->popup(pos);
+        menu->close();
+    }
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::setIcon_data()
+{
+    addBackendRows();
+}
+
+void PlatformAgnosticMenuBenchmark::setIcon()
+{
+    QFETCH(QString, backend);
+
+    const auto menu = createRootMenu(backend);
+    const auto action = menu->addAction(QStringLiteral("Action"));
+
+    QBENCHMARK {
+        action->setIcon(QStringLiteral(":/benchmark/icon.png"));
+    }
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::setShortcut_data()
+{
+    addBackendRows();
+}
+
+void PlatformAgnosticMenuBenchmark::setShortcut()
+{
+    QFETCH(QString, backend);
+
+    const auto menu = createRootMenu(backend);
+    const auto action = menu->addAction(QStringLiteral("Action"));
+    const QKeySequence shortcut{QStringLiteral("Ctrl+B")};
+
+    QBENCHMARK {
+        action->setShortcut(shortcut);
+    }
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::actionGroupAddRemove_data()
+{
+    addBackendCountRows({10, 100});
+}
+
+void PlatformAgnosticMenuBenchmark::actionGroupAddRemove()
+{
+    QFETCH(QString, backend);
+    QFETCH(int, count);
+
+    const auto menu = createRootMenu(backend);
+    const auto actionGroup = PlatformAgnosticActionGroup::createActionGroup(menu);
+    const auto actionList = createActions(menu, count);
+
+    QBENCHMARK {
+        for (const auto action : actionList)
+            actionGroup->addAction(action);
+        for (const auto action : actionList)
+            actionGroup->removeAction(action);
+    }
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::actionGroupRepopulate_data()
+{
+    addBackendCountRows({10, 100, 1000});
+}
+
+void PlatformAgnosticMenuBenchmark::actionGroupRepopulate()
+{
+    QFETCH(QString, backend);
+    QFETCH(int, count);
+
+    const auto menu = createRootMenu(backend);
+    const auto actionGroup = PlatformAgnosticActionGroup::createActionGroup(menu);
+    const auto actionList = createActions(menu, count);
+    for (const auto action : actionList)
+        action->setCheckable(true);
+
+    // What a track selection menu does on every media change
+    QBENCHMARK {
+        actionGroup->addActions(actionList);
+        actionGroup->setCheckedIndex(count / 2);
+        QVERIFY(actionGroup->checkedAction() == actionList.at(count / 2));
+        actionGroup->clear();
+    }
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::stateUpdates_data()
+{
+    QTest::addColumn<QString>("backend");
+    QTest::addColumn<bool>("useQueue");
+
+    for (const auto backend : {"widgets", "quick"})
+    {
+        QTest::addRow("%s/invokeMethod", backend) << QString::fromLatin1(backend) << false;
+        QTest::addRow("%s/queue", backend) << QString::fromLatin1(backend) << true;
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::stateUpdates()
+{
+    QFETCH(QString, backend);
+    QFETCH(bool, useQueue);
+
+    const auto menu = createRootMenu(backend);
+    const auto actionList = createActions(menu, 10);
+    for (const auto action : actionList)
+        menu->addAction(action);
+
+    PlatformAgnosticActionStateQueue queue;
+
+    // A playback thread updating a few actions many times between two frames
+    QBENCHMARK {
+        for (auto i = 0; i < 1000; ++i)
+        {
+            const auto action = actionList.at(i % actionList.size());
+            const bool state = (i % 2);
+            if (useQueue)
+            {
+                queue.setEnabled(action, state);
+                queue.setChecked(action, state);
+            }
+            else
+            {
+                QMetaObject::invokeMethod(action, "setEnabled", Qt::QueuedConnection, Q_ARG(bool, state));
+                QMetaObject::invokeMethod(action, "setChecked", Qt::QueuedConnection, Q_ARG(bool, state));
+            }
+        }
+        QCoreApplication::processEvents();
+    }
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::fromMenu()
+{
+    QBENCHMARK {
+        // The wrapper takes care of deleting the wrapped menu
+        delete PlatformAgnosticMenu::fromMenu(new QMenu);
+        flushDeferredDeletes();
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::eventDispatch_data()
+{
+    QTest::addColumn<bool>("useHandlers");
+    QTest::addColumn<int>("subscribers");
+
+    for (const auto subscribers : {1, 10, 50})
+    {
+        QTest::addRow("filters/%d", subscribers) << false << subscribers;
+        QTest::addRow("handlers/%d", subscribers) << true << subscribers;
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::eventDispatch()
+{
+    QFETCH(bool, useHandlers);
+    QFETCH(int, subscribers);
+
+    // Filters that only care about key presses, receiving other events
+    class KeyPressFilter : public QObject
+    {
+    protected:
+        bool eventFilter(QObject*, QEvent* event) override
+        {
+            return event->type() == QEvent::KeyPress;
+        }
+    };
+
+    const auto nativeMenu = new QMenu;
+    const auto menu = PlatformAgnosticMenu::fromMenu(nativeMenu);
+
+    std::vector<std::unique_ptr<KeyPressFilter>> filters;
+    for (auto i = 0; i < subscribers; ++i)
+    {
+        if (useHandlers)
+        {
+            menu->addEventHandler(QEvent::KeyPress, [](QEvent*) { return true; });
+        }
+        else
+        {
+            filters.push_back(std::make_unique<KeyPressFilter>());
+            menu->installEventFilter(filters.back().get());
+        }
+    }
+
+    QEvent event(QEvent::User);
+    QBENCHMARK {
+        for (auto i = 0; i < 1000; ++i)
+            QCoreApplication::sendEvent(nativeMenu, &event);
+    }
+
+    for (const auto& filter : filters)
+        menu->removeEventFilter(filter.get());
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::staticDispatch_data()
+{
+    QTest::addColumn<QString>("backend");
+    QTest::addColumn<bool>("isStatic");
+    QTest::addColumn<int>("count");
+
+    for (const auto backend : {"widgets", "quick", "null"})
+    {
+        for (const auto count : {10, 100, 10000})
+        {
+            QTest::addRow("%s/virtual/%d", backend, count) << QString::fromLatin1(backend) << false << count;
+            QTest::addRow("%s/static/%d", backend, count) << QString::fromLatin1(backend) << true << count;
+        }
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::staticDispatch()
+{
+    QFETCH(QString, backend);
+    QFETCH(bool, isStatic);
+    QFETCH(int, count);
+
+    const auto menu = createRootMenu(backend);
+
+    if (backend == QLatin1String("widgets"))
+        runStaticDispatch<WidgetsBackend>(menu, isStatic, count);
+    else if (backend == QLatin1String("null"))
+        runStaticDispatch<NullBackend>(menu, isStatic, count);
+    else
+        runStaticDispatch<QuickControls2Backend>(menu, isStatic, count);
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+template<class Backend>
+void PlatformAgnosticMenuBenchmark::runStaticDispatch(PlatformAgnosticMenu* menu, const bool isStatic, const int count) const
+{
+    // Creating, adding and removing actions, the calls the typed handle resolves at compile time
+    if (isStatic)
+    {
+        auto basicMenu = BasicMenu<Backend>::fromMenu(menu);
+        QBENCHMARK {
+            for (auto i = 0; i < count; ++i)
+                basicMenu.addAction(QStringLiteral("action"));
+            basicMenu->clear();
+        }
+    }
+    else
+    {
+        QBENCHMARK {
+            for (auto i = 0; i < count; ++i)
+                menu->addAction(QStringLiteral("action"));
+            menu->clear();
+        }
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::filter_data()
+{
+    addBackendCountRows();
+}
+
+void PlatformAgnosticMenuBenchmark::filter()
+{
+    QFETCH(QString, backend);
+    QFETCH(int, count);
+
+    const auto menu = createRootMenu(backend);
+    for (const auto action : createActions(menu, count))
+        menu->addAction(action);
+
+    // Type ahead: every keystroke narrows the filter
+    QBENCHMARK {
+        menu->setFilter(QStringLiteral("a"));
+        menu->setFilter(QStringLiteral("action 1"));
+        menu->setFilter(QStringLiteral("action 12"));
+        menu->clearFilter();
+    }
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::filterAfterTextChange_data()
+{
+    addBackendCountRows();
+}
+
+void PlatformAgnosticMenuBenchmark::filterAfterTextChange()
+{
+    QFETCH(QString, backend);
+    QFETCH(int, count);
+
+    const auto menu = createRootMenu(backend);
+    const auto actionList = createActions(menu, count);
+    for (const auto action : actionList)
+        menu->addAction(action);
+
+    menu->setFilter(QStringLiteral("action 1"));
+    bool toggle = false;
+
+    // One action changes its text between two queries
+    QBENCHMARK {
+        toggle = !toggle;
+        actionList.first()->setText(toggle ? QStringLiteral("First") : QStringLiteral("Action 0"));
+        menu->setFilter(QStringLiteral("action 12"));
+        menu->setFilter(QStringLiteral("action 1"));
+    }
+
+    QCOMPARE(menu->actions().size(), count);
+
+    // A hidden action is indexed by the text it shows once it is visible again
+    const auto hidden = PlatformAgnosticAction::createAction(QStringLiteral("Hidden 1"), menu);
+    hidden->setVisible(false);
+    menu->addAction(hidden);
+    QVERIFY(menu->findActions(QStringLiteral("hidden 1")).contains(hidden));
+    hidden->setVisible(true);
+    QVERIFY(menu->findActions(QStringLiteral("hidden 1")).contains(hidden));
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::firstQuickMenu_data()
+{
+    QTest::addColumn<bool>("createMenu");
+
+    QTest::newRow("engine") << false;
+    QTest::newRow("engine+menu") << true;
+}
+
+void PlatformAgnosticMenuBenchmark::firstQuickMenu()
+{
+    QFETCH(bool, createMenu);
+
+    // A fresh engine per iteration, so that the type cache is cold as it is
+    // on application startup. The "engine" row is the baseline to subtract.
+    QBENCHMARK {
+        QQmlEngine engine;
+        QQmlComponent component(&engine);
+        component.setData("import QtQuick 2.12\nItem {}", QUrl());
+        const std::unique_ptr<QObject> rootItem{component.create()};
+        QVERIFY(rootItem);
+
+        if (createMenu)
+            delete PlatformAgnosticMenu::createMenu(rootItem.get());
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::memoryPerAction_data()
+{
+    QTest::addColumn<QString>("backend");
+    QTest::addColumn<bool>("lazy");
+
+    for (const auto backend : {QStringLiteral("widgets"), QStringLiteral("quick"), QStringLiteral("null")})
+    {
+        QTest::addRow("%s/eager", qPrintable(backend)) << backend << false;
+        QTest::addRow("%s/lazy", qPrintable(backend)) << backend << true;
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::memoryPerAction()
+{
+    QFETCH(QString, backend);
+    QFETCH(bool, lazy);
+
+    if (allocatedBytes() < 0)
+        QSKIP("Heap statistics are not available on this platform");
+
+    constexpr int count = 20000;
+
+    const auto menu = createRootMenu(backend);
+
+    const qint64 before = allocatedBytes();
+
+    for (int i = 0; i < count; ++i)
+    {
+        const auto text = QStringLiteral("Action %1").arg(i);
+        menu->addAction(lazy ? PlatformAgnosticAction::createLazyAction(text, menu)
+                             : PlatformAgnosticAction::createAction(text, menu));
+    }
+
+    QTest::setBenchmarkResult(static_cast<qreal>(allocatedBytes() - before) / count, QTest::BytesAllocated);
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::separatorRebuild_data()
+{
+    addBackendRows();
+}
+
+void PlatformAgnosticMenuBenchmark::separatorRebuild()
+{
+    QFETCH(QString, backend);
+
+    const auto menu = createRootMenu(backend);
+
+    // A menu that is rebuilt on every show, 10 sections of 3 actions
+    QBENCHMARK {
+        menu->clear();
+        for (int i = 0; i < 10; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+                menu->addAction(QStringLiteral("Action %1").arg(j));
+            menu->addSeparator();
+        }
+    }
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::memoryPerSeparator_data()
+{
+    QTest::addColumn<QString>("backend");
+    QTest::addColumn<bool>("rebuilt");
+
+    for (const auto backend : {QStringLiteral("widgets"), QStringLiteral("quick"), QStringLiteral("null")})
+    {
+        QTest::addRow("%s/first", qPrintable(backend)) << backend << false;
+        QTest::addRow("%s/rebuilt", qPrintable(backend)) << backend << true;
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::memoryPerSeparator()
+{
+    QFETCH(QString, backend);
+    QFETCH(bool, rebuilt);
+
+    if (allocatedBytes() < 0)
+        QSKIP("Heap statistics are not available on this platform");
+
+    constexpr int count = 1000;
+
+    const auto menu = createRootMenu(backend);
+
+    if (rebuilt)
+    {
+        for (int i = 0; i < count; ++i)
+            menu->addSeparator();
+        menu->clear();
+    }
+
+    const qint64 before = allocatedBytes();
+
+    for (int i = 0; i < count; ++i)
+        menu->addSeparator();
+
+    QTest::setBenchmarkResult(static_cast<qreal>(allocatedBytes() - before) / count, QTest::BytesAllocated);
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::arenaBuildTeardown_data()
+{
+    addArenaRows();
+}
+
+void PlatformAgnosticMenuBenchmark::arenaBuildTeardown()
+{
+    QFETCH(QString, backend);
+    QFETCH(bool, arena);
+
+    // 10 submenus of 100 actions
+    QBENCHMARK {
+        const auto menu = createRootMenu(backend);
+        {
+            std::unique_ptr<PlatformAgnosticArena::Scope> scope;
+            if (arena)
+                scope = std::make_unique<PlatformAgnosticArena::Scope>(menu);
+            buildTree(menu, 10, 100);
+        }
+        delete menu;
+        flushDeferredDeletes();
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::arenaFragmentation_data()
+{
+    addArenaRows();
+}
+
+void PlatformAgnosticMenuBenchmark::arenaFragmentation()
+{
+    QFETCH(QString, backend);
+    QFETCH(bool, arena);
+
+    if (freeHeapBytes() < 0)
+        QSKIP("Heap statistics are not available on this platform");
+
+    constexpr int cycles = 10000;
+
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+    const qint64 before = freeHeapBytes();
+
+    // An allocation of the application survives each cycle, interleaved with the
+    // memory of the menus. The free memory left in the heap afterwards is the
+    // fragmentation, reported in the bytes column.
+    std::vector<QByteArray> survivors;
+    survivors.reserve(cycles);
+
+    for (int i = 0; i < cycles; ++i)
+    {
+        const auto menu = createRootMenu(backend);
+        {
+            std::unique_ptr<PlatformAgnosticArena::Scope> scope;
+            if (arena)
+                scope = std::make_unique<PlatformAgnosticArena::Scope>(menu);
+            buildTree(menu, 2, 10);
+        }
+
+        survivors.emplace_back(64, 'x');
+
+        delete menu;
+        flushDeferredDeletes();
+    }
+
+    QTest::setBenchmarkResult(static_cast<qreal>(freeHeapBytes() - before), QTest::BytesAllocated);
+}
+
+void PlatformAgnosticMenuBenchmark::popupToFrame_data()
+{
+    QTest::addColumn<bool>("fastPopup");
+    QTest::addColumn<int>("count");
+
+    for (const int count : {10, 100})
+    {
+        QTest::addRow("quick/default/%d", count) << false << count;
+        QTest::addRow("quick/fast/%d", count) << true << count;
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::popupToFrame()
+{
+    QFETCH(bool, fastPopup);
+    QFETCH(int, count);
+
+    // The time from popup() to the first frame of the opened menu. Run with
+    // QT_QPA_PLATFORM=offscreen, and set QT_QUICK_CONTROLS_STYLE to compare
+    // styles with enter transitions, such as Material.
+    const auto menu = createRootMenu(QStringLiteral("quick"));
+    for (const auto action : createActions(menu, count))
+        menu->addAction(action);
+    menu->setFastPopup(fastPopup);
+
+    QObject* quickMenu = nullptr;
+    for (const auto child : menu->children())
+    {
+        if (child->inherits("QQuickMenu"))
+            quickMenu = child;
+    }
+    QVERIFY(quickMenu);
+
+    // The style transitions are dropped by fast popup only
+    if (fastPopup)
+    {
+        QVERIFY(!QQmlProperty::read(quickMenu, QStringLiteral("enter")).value<QObject*>());
+        QVERIFY(!QQmlProperty::read(quickMenu, QStringLiteral("exit")).value<QObject*>());
+    }
+
+    const QPoint pos = m_window->mapToGlobal(QPoint{10, 10});
+    constexpr int iterations = 20;
+    qint64 elapsed = 0;
+
+    for (int i = 0; i < iterations; ++i)
+    {
+        // Lets the pre-layout run while the menu is hidden
+        QCoreApplication::processEvents();
+
+        QSignalSpy opened(quickMenu, SIGNAL(opened()));
+        QElapsedTimer timer;
+        timer.start();
+
+        menu->popup(pos);
+        QVERIFY(opened.count() || opened.wait(1000));
+
+        QSignalSpy frameSwapped(m_window, &QQuickWindow::frameSwapped);
+        m_window->update();
+        QVERIFY(frameSwapped.wait(1000));
+        elapsed += timer.nsecsElapsed();
+
+        QSignalSpy closed(quickMenu, SIGNAL(closed()));
+        menu->close();
+        QVERIFY(closed.count() || closed.wait(1000));
+    }
+
+    QTest::setBenchmarkResult(static_cast<qreal>(elapsed) / 1e6 / iterations, QTest::WalltimeMilliseconds);
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::hibernationReclaimed_data()
+{
+    addBackendRows();
+}
+
+void PlatformAgnosticMenuBenchmark::hibernationReclaimed()
+{
+    QFETCH(QString, backend);
+
+    if (allocatedBytes() < 0)
+        QSKIP("Heap statistics are not available on this platform");
+
+    constexpr int count = 1000;
+
+    const auto menu = createRootMenu(backend);
+    buildSeparatedActions(menu, count);
+    const QPointer<QObject> item = addHibernationState(menu, backend);
+    const auto actionList = menu->actions();
+    const QStringList content = describeContent(menu);
+
+    // Bytes reclaimed per action, separators included
+    const qint64 reclaimed = menu->hibernate();
+    QVERIFY(menu->isHibernated());
+
+    QTest::setBenchmarkResult(static_cast<qreal>(reclaimed) / count, QTest::BytesAllocated);
+
+    // The shortcut keeps working, the other actions are released
+    QVERIFY(!actionList.first()->isLazy());
+    QVERIFY(actionList.last()->isLazy());
+    QVERIFY(item);
+
+    // Nothing is lost once the content is created again
+    QCOMPARE(describeContent(menu), content);
+    QCOMPARE(menu->actions(), actionList);
+    QVERIFY(item);
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::rehydrate_data()
+{
+    addBackendCountRows({10, 100});
+}
+
+void PlatformAgnosticMenuBenchmark::rehydrate()
+{
+    QFETCH(QString, backend);
+    QFETCH(int, count);
+
+    const auto menu = createRootMenu(backend);
+    buildSeparatedActions(menu, count);
+    const QPointer<QObject> item = addHibernationState(menu, backend);
+    const auto actionList = menu->actions();
+    const QStringList content = describeContent(menu);
+
+    // sizeHint() creates the content again, like popup() does
+    QBENCHMARK {
+        menu->hibernate();
+        menu->sizeHint();
+    }
+
+    QCOMPARE(describeContent(menu), content);
+    QCOMPARE(menu->actions(), actionList);
+    QVERIFY(item);
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::speculativeSubmenu_data()
+{
+    QTest::addColumn<QString>("backend");
+    QTest::addColumn<bool>("speculative");
+
+    for (const auto backend : {QStringLiteral("widgets"), QStringLiteral("quick"), QStringLiteral("null")})
+    {
+        QTest::addRow("%s/on-show", qPrintable(backend)) << backend << false;
+        QTest::addRow("%s/speculative", qPrintable(backend)) << backend << true;
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::speculativeSubmenu()
+{
+    QFETCH(QString, backend);
+    QFETCH(bool, speculative);
+
+    // The work left when a heavy submenu is shown, after the idle time
+    // of a hover has been given to the speculative builder, or not
+    constexpr int count = 500;
+    constexpr int iterations = 10;
+
+    const auto menu = createRootMenu(backend);
+    const auto submenu = menu->addMenu(QStringLiteral("Submenu"));
+    submenu->setContentProvider([](PlatformAgnosticMenu* menu) {
+        for (int i = 0; i < count; ++i)
+            menu->addAction(PlatformAgnosticAction::createLazyAction(QStringLiteral("Action %1").arg(i), menu));
+    });
+
+    qint64 elapsed = 0;
+
+    for (int i = 0; i < iterations; ++i)
+    {
+        submenu->invalidateContent();
+        flushDeferredDeletes();
+
+        if (speculative)
+        {
+            PlatformAgnosticSpeculativeBuilder::schedule(submenu, true);
+            while (PlatformAgnosticSpeculativeBuilder::isScheduled(submenu))
+                QCoreApplication::processEvents();
+        }
+
+        // What a show does, before the menu can be laid out
+        QElapsedTimer timer;
+        timer.start();
+        QVERIFY(submenu->buildContent());
+        elapsed += timer.nsecsElapsed();
+    }
+
+    QTest::setBenchmarkResult(static_cast<qreal>(elapsed) / 1e6 / iterations, QTest::WalltimeMilliseconds);
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::mruTouch_data()
+{
+    QTest::addColumn<QString>("backend");
+    QTest::addColumn<bool>("section");
+
+    for (const auto backend : {QStringLiteral("widgets"), QStringLiteral("quick"), QStringLiteral("null")})
+    {
+        QTest::addRow("%s/reinsert", qPrintable(backend)) << backend << false;
+        QTest::addRow("%s/section", qPrintable(backend)) << backend << true;
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::mruTouch()
+{
+    QFETCH(QString, backend);
+    QFETCH(bool, section);
+
+    // Ten recent entries out of twenty files, so that touches both move and replace entries
+    constexpr int capacity = 10;
+    constexpr int fileCount = 20;
+
+    const auto menu = createRootMenu(backend);
+    for (const auto action : createActions(menu, 10))
+        menu->addAction(action);
+    menu->addSeparator();
+
+    // Owned by the menu
+    const auto mru = new PlatformAgnosticMruSection(menu, capacity);
+    QList<PlatformAgnosticAction*> recentActions;
+
+    int i = 0;
+
+    QBENCHMARK {
+        const QString text = QStringLiteral("File %1").arg((i * 7) % fileCount);
+        ++i;
+
+        if (section)
+        {
+            mru->touch(text);
+            continue;
+        }
+
+        // Moving the action to the top, as it had to be done without the section
+        PlatformAgnosticAction* action = nullptr;
+        for (const auto recentAction : std::as_const(recentActions))
+        {
+            if (recentAction->text() == text)
+                action = recentAction;
+        }
+
+        if (action)
+        {
+            recentActions.removeOne(action);
+            menu->removeAction(action);
+        }
+        else
+        {
+            action = PlatformAgnosticAction::createAction(text, menu);
+            if (recentActions.size() == capacity)
+                delete recentActions.takeLast();
+        }
+
+        if (recentActions.isEmpty())
+            menu->addAction(action);
+        else
+            menu->insertAction(recentActions.first(), action);
+        recentActions.prepend(action);
+    }
+
+    // The most recent file first, whichever way the menu was updated
+    QStringList expected;
+    for (int j = 0; j < i; ++j)
+    {
+        const QString text = QStringLiteral("File %1").arg((j * 7) % fileCount);
+        expected.removeOne(text);
+        expected.prepend(text);
+        if (expected.size() > capacity)
+            expected.removeLast();
+    }
+
+    const auto recent = menu->actions().mid(10);
+    QVERIFY(recent.size() >= expected.size());
+    for (qsizetype k = 0; k < expected.size(); ++k)
+    {
+        QVERIFY(recent[k]->isVisible());
+        QCOMPARE(recent[k]->text(), expected[k]);
+    }
+
+    if (section)
+    {
+        QCOMPARE(mru->count(), int(expected.size()));
+        for (int k = 0; k < mru->count(); ++k)
+            QCOMPARE(mru->text(k), expected[k]);
+    }
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::stateProviders_data()
+{
+    QTest::addColumn<QString>("backend");
+    QTest::addColumn<bool>("pull");
+
+    for (const auto backend : {QStringLiteral("widgets"), QStringLiteral("quick"), QStringLiteral("null")})
+    {
+        QTest::addRow("%s/push", qPrintable(backend)) << backend << false;
+        QTest::addRow("%s/pull", qPrintable(backend)) << backend << true;
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::stateProviders()
+{
+    QFETCH(QString, backend);
+    QFETCH(bool, pull);
+
+    // Ten changes of the application state per show of the menu
+    constexpr int count = 1000;
+    constexpr int changesPerShow = 10;
+
+    const auto menu = createRootMenu(backend);
+    const auto actionList = createActions(menu, count);
+
+    bool enabled = true;
+
+    for (const auto action : actionList)
+    {
+        menu->addAction(action);
+        if (pull)
+            action->setEnabledProvider([&enabled]() { return enabled; });
+    }
+
+    const QPoint pos = m_window->mapToGlobal(QPoint{10, 10});
+
+    QBENCHMARK {
+        for (int i = 0; i < changesPerShow; ++i)
+        {
+            enabled = !enabled;
+
+            if (!pull)
+            {
+                for (const auto action : actionList)
+                    action->setEnabled(enabled);
+            }
+        }
+
+        menu->popup(pos);
+        menu->close();
+    }
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::pagedPopup_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("pageSize");
+
+    for (const int count : {100, 5000})
+    {
+        QTest::addRow("widgets/%d/all", count) << count << 0;
+        QTest::addRow("widgets/%d/paged", count) << count << 30;
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::pagedPopup()
+{
+    QFETCH(int, count);
+    QFETCH(int, pageSize);
+
+    const auto menu = createRootMenu(QStringLiteral("widgets"));
+    menu->setPageSize(pageSize);
+
+    const auto actionList = createActions(menu, count);
+    for (const auto action : actionList)
+        menu->addAction(action);
+
+    const QPoint pos = m_window->mapToGlobal(QPoint{10, 10});
+    bool toggle = false;
+
+    QBENCHMARK {
+        // A changed action makes QMenu lay out all of its actions again
+        toggle = !toggle;
+        actionList.first()->setText(toggle ? QStringLiteral("First") : QStringLiteral("Action 0"));
+
+        menu->popup(pos);
+        menu->close();
+    }
+
+    QCOMPARE(menu->actions().size(), count);
+
+    // The actions off the page are still reported by the menu
+    QSignalSpy triggered(menu, &PlatformAgnosticMenu::triggered);
+    const auto lastAction = actionList.last()->findChild<QAction*>();
+    QVERIFY(lastAction);
+    lastAction->trigger();
+    QCOMPARE(triggered.count(), 1);
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::accountingSnapshot_data()
+{
+    QTest::addColumn<QString>("backend");
+    QTest::addColumn<int>("count");
+
+    for (const auto backend : {QStringLiteral("widgets"), QStringLiteral("quick"), QStringLiteral("null")})
+    {
+        for (const int count : {100, 10000})
+            QTest::addRow("%s/%d", qPrintable(backend), count) << backend << count;
+    }
+}
+
+void PlatformAgnosticMenuBenchmark::accountingSnapshot()
+{
+    QFETCH(QString, backend);
+    QFETCH(int, count);
+
+    const auto baseline = PlatformAgnosticAccounting::snapshot().total();
+
+    const auto menu = createRootMenu(backend);
+    const auto actionList = createActions(menu, count);
+    for (const auto action : actionList)
+    {
+        // A trailing separator may be deferred
+        if (action == actionList.last())
+            menu->addSeparator();
+        menu->addAction(action);
+    }
+
+    PlatformAgnosticAccounting::Snapshot snapshot;
+
+    QBENCHMARK {
+        snapshot = PlatformAgnosticAccounting::snapshot();
+    }
+
+    QCOMPARE(snapshot.total().menus, baseline.menus + 1);
+    QCOMPARE(snapshot.total().actions, baseline.actions + count);
+    QCOMPARE(snapshot.total().separators, baseline.separators + 1);
+
+    delete menu;
+    flushDeferredDeletes();
+}
+
+void PlatformAgnosticMenuBenchmark::accountingLeaks()
+{
+    // What is left over after each backend built and tore down a menu
+    const auto baseline = PlatformAgnosticAccounting::snapshot().total();
+
+    for (const auto backend : {QStringLiteral("widgets"), QStringLiteral("quick"), QStringLiteral("null")})
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            const auto menu = createRootMenu(backend);
+            const auto actionGroup = PlatformAgnosticActionGroup::createActionGroup(menu);
+
+            const auto actionList = createActions(menu, 100);
+            for (const auto action : actionList)
+            {
+                menu->addAction(action);
+                menu->addSeparator();
+                action->setActionGroup(actionGroup);
+            }
+
+            menu->clear();
+            delete menu;
+            flushDeferredDeletes();
+        }
+    }
+
+    // The wrappers of native objects go with them
+    for (int i = 0; i < 10; ++i)
+    {
+        const auto nativeMenu = new QMenu;
+        const auto menu = PlatformAgnosticMenu::fromMenu(nativeMenu);
+
+        const auto nativeAction = new QAction(QStringLiteral("Native"));
+        const auto nativeActionGroup = new QActionGroup(nullptr);
+        PlatformAgnosticAction::fromAction(nativeAction)->setActionGroup(PlatformAgnosticActionGroup::fromActionGroup(nativeActionGroup));
+        nativeMenu->addAction(nativeAction);
+
+        menu->addSeparator();
+
+        delete nativeMenu;
+        delete nativeAction;
+        delete nativeActionGroup;
+        flushDeferredDeletes();
+    }
+
+    const auto leftOver = PlatformAgnosticAccounting::snapshot().total();
+
+    QCOMPARE(leftOver.menus, baseline.menus);
+    QCOMPARE(leftOver.actions, baseline.actions);
+    QCOMPARE(leftOver.actionGroups, baseline.actionGroups);
+    QCOMPARE(leftOver.nativeObjects, baseline.nativeObjects);
+    QCOMPARE(leftOver.separators, baseline.separators);
+}
+
+QTEST_MAIN(PlatformAgnosticMenuBenchmark)
+
+void PlatformAgnosticMenuBenchmark::traceRoundTrip()
+{
+    using PlatformAgnosticTrace::Op;
+
+    QBuffer buffer;
+    buffer.open(QIODevice::ReadWrite);
+
+    // Created before the recording, and so adopted on first use
+    const auto menu = new NullMenu;
+
+    // The action created by the provider is part of the recorded popup() call
+    PlatformAgnosticAction* provided = nullptr;
+    menu->setContentProvider([&provided](PlatformAgnosticMenu* menu) {
+        provided = menu->addAction(QStringLiteral("Provided"));
+    });
+
+    QVERIFY(PlatformAgnosticTrace::start(&buffer));
+
+    const auto action = PlatformAgnosticAction::createAction(menu);
+    action->setText(QStringLiteral("Open"));
+    menu->addAction(action);
+    menu->popup(QPoint(1, 2));
+    QVERIFY(provided);
+    provided->setChecked(true);
+    delete action;
+
+    PlatformAgnosticTrace::stop();
+    delete menu;
+
+    const QList<std::tuple<Op, quint32, QVariantList>> expected{
+        {Op::AdoptMenu, 1, {}},
+        {Op::CreateAction, 2, {quint32(1), false}},
+        {Op::ActionSetText, 2, {QStringLiteral("Open")}},
+        {Op::MenuAddAction, 1, {quint32(2)}},
+        {Op::MenuPopup, 1, {QPoint(1, 2)}},
+        {Op::AdoptAction, 3, {}},
+        {Op::ActionSetChecked, 3, {true}},
+        {Op::Destroy, 2, {}},
+    };
+
+    buffer.seek(0);
+    PlatformAgnosticTrace::Reader reader(&buffer);
+    QVERIFY(reader.isValid());
+
+    PlatformAgnosticTrace::Record record;
+    for (const auto& [op, object, arguments] : expected)
+    {
+        QVERIFY(reader.readNext(record));
+        QCOMPARE(PlatformAgnosticTrace::opName(record.op), PlatformAgnosticTrace::opName(op));
+        QCOMPARE(record.object, object);
+        QCOMPARE(record.arguments, arguments);
+    }
+
+    // The end of the log, not a truncated record
+    QVERIFY(!reader.readNext(record));
+    QVERIFY(reader.isValid());
+}
+
+void PlatformAgnosticMenuBenchmark::triggerHandlers()
+{
+    const auto menu = new NullMenu;
+
+    int count = 0;
+    const auto first = static_cast<NullAction*>(menu->addAction(QStringLiteral("First"), [&count]() { ++count; }));
+    const auto second = static_cast<NullAction*>(menu->addAction(QStringLiteral("Second"), [&count]() { count += 10; }));
+
+    first->trigger();
+    QCOMPARE(count, 1);
+
+    // Moving an action within the menu keeps its functor
+    menu->addAction(first);
+    menu->insertAction(second, first);
+    first->trigger();
+    QCOMPARE(count, 2);
+
+    // Removing it drops the functor, adding it again does not bring it back
+    menu->removeAction(second);
+    menu->addAction(second);
+    second->trigger();
+    QCOMPARE(count, 2);
+
+    delete menu;
+}
+
+#include "benchmark.moc"
@@ -0,0 +1,377 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QKeySequence>
+#include <QPointer>
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QQuickItem>
+#include <QQuickWindow>
+#include <QTextStream>
+
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <utility>
+
+#include "platformagnosticmenus.hpp"
+
+// Replays a log written by PlatformAgnosticTrace against one backend, headless,
+// and compares the time of each operation with the recorded time. Calls on objects
+// that the log does not create, or that are already destroyed, are skipped.
+
+namespace
+{
+
+using PlatformAgnosticTrace::Op;
+using PlatformAgnosticTrace::Record;
+
+struct OpStats
+{
+    int count = 0;
+    int skipped = 0;
+    qint64 recorded = 0;
+    qint64 replayed = 0;
+};
+
+using Stats = std::array<OpStats, size_t(Op::Count)>;
+
+class Replayer
+{
+public:
+    // Objects without a recorded parent are created in rootItem, which is only needed by Qt Quick
+    explicit Replayer(QObject* rootItem) : m_rootItem(rootItem) {}
+    ~Replayer() { destroyAll(); }
+
+    bool apply(const Record& record);
+    void destroyAll();
+
+private:
+    template<class T>
+    T* object(const QVariant& id) const { return object<T>(id.value<quint32>()); }
+    template<class T>
+    T* object(const quint32 id) const { return qobject_cast<T*>(m_objects.value(id).data()); }
+
+    QObject* parent(const QVariant& id) const;
+
+    QObject* m_rootItem;
+    QHash<quint32, QPointer<QObject>> m_objects;
+};
+
+QObject *Replayer::parent(const QVariant &id) const
+{
+    const auto parent = m_objects.value(id.value<quint32>());
+    return parent ? parent.data() : m_rootItem;
+}
+
+bool Replayer::apply(const Record &record)
+{
+    const auto& args = record.arguments;
+
+    switch (record.op)
+    {
+    case Op::CreateMenu:
+        m_objects.insert(record.object, PlatformAgnosticMenu::createMenu(parent(args.at(0))));
+        return true;
+    case Op::CreateAction:
+        m_objects.insert(record.object, args.at(1).toBool()
+                                            ? PlatformAgnosticAction::createLazyAction(parent(args.at(0)))
+                                            : PlatformAgnosticAction::createAction(parent(args.at(0))));
+        return true;
+    case Op::CreateActionGroup:
+        m_objects.insert(record.object, PlatformAgnosticActionGroup::createActionGroup(parent(args.at(0))));
+        return true;
+    // The recorded program wrapped them, the replay creates equivalent objects
+    case Op::AdoptMenu:
+        m_objects.insert(record.object, PlatformAgnosticMenu::createMenu(m_rootItem));
+        return true;
+    case Op::AdoptAction:
+        m_objects.insert(record.object, PlatformAgnosticAction::createAction(m_rootItem));
+        return true;
+    case Op::AdoptActionGroup:
+        m_objects.insert(record.object, PlatformAgnosticActionGroup::createActionGroup(m_rootItem));
+        return true;
+    case Op::Destroy:
+    {
+        const auto object = m_objects.take(record.object);
+        if (!object)
+            return false;
+        delete object.data();
+        return true;
+    }
+    default:
+        break;
+    }
+
+    if (record.op <= Op::MenuClearFilter)
+    {
+        const auto menu = object<PlatformAgnosticMenu>(record.object);
+        if (!menu)
+            return false;
+
+        switch (record.op)
+        {
+        case Op::MenuInsertAction:
+        {
+            const auto action = object<PlatformAgnosticAction>(args.at(1));
+            if (!action)
+                return false;
+            menu->insertAction(object<PlatformAgnosticAction>(args.at(0)), action);
+            return true;
+        }
+        case Op::MenuAddAction:
+        case Op::MenuRemoveAction:
+        {
+            const auto action = object<PlatformAgnosticAction>(args.at(0));
+            if (!action)
+                return false;
+            if (record.op == Op::MenuAddAction)
+                menu->addAction(action);
+            else
+                menu->removeAction(action);
+            return true;
+        }
+        case Op::MenuAddMenu:
+        {
+            const auto subMenu = object<PlatformAgnosticMenu>(args.at(0));
+            if (!subMenu)
+                return false;
+            menu->addMenu(subMenu);
+            return true;
+        }
+        case Op::MenuAddSeparator: menu->addSeparator(); return true;
+        case Op::MenuClear: menu->clear(); return true;
+        case Op::MenuSetTitle: menu->setTitle(args.at(0).toString()); return true;
+        case Op::MenuSetEnabled: menu->setEnabled(args.at(0).toBool()); return true;
+        case Op::MenuPopup: menu->popup(args.at(0).toPoint()); return true;
+        case Op::MenuClose: menu->close(); return true;
+        case Op::MenuSetFilter:
+            menu->setFilter(args.at(0).toString(), PlatformAgnosticMenu::FilterMode(args.at(1).toInt()));
+            return true;
+        case Op::MenuClearFilter: menu->clearFilter(); return true;
+        default: Q_UNREACHABLE();
+        }
+    }
+
+    if (record.op <= Op::ActionSetActionGroup)
+    {
+        const auto action = object<PlatformAgnosticAction>(record.object);
+        if (!action)
+            return false;
+
+        switch (record.op)
+        {
+        case Op::ActionSetText: action->setText(args.at(0).toString()); return true;
+        case Op::ActionSetVisible: action->setVisible(args.at(0).toBool()); return true;
+        case Op::ActionSetEnabled: action->setEnabled(args.at(0).toBool()); return true;
+        case Op::ActionSetChecked: action->setChecked(args.at(0).toBool()); return true;
+        case Op::ActionSetCheckable: action->setCheckable(args.at(0).toBool()); return true;
+        case Op::ActionSetShortcut:
+            action->setShortcut(QKeySequence(args.at(0).toString(), QKeySequence::PortableText));
+            return true;
+        case Op::ActionSetIcon: action->setIcon(args.at(0).toString(), args.at(1).toBool()); return true;
+        case Op::ActionSetActionGroup:
+            action->setActionGroup(object<PlatformAgnosticActionGroup>(args.at(0)));
+            return true;
+        default: Q_UNREACHABLE();
+        }
+    }
+
+    const auto actionGroup = object<PlatformAgnosticActionGroup>(record.object);
+    if (!actionGroup)
+        return false;
+
+    switch (record.op)
+    {
+    case Op::ActionGroupAddAction:
+    case Op::ActionGroupRemoveAction:
+    {
+        const auto action = object<PlatformAgnosticAction>(args.at(0));
+        if (!action)
+            return false;
+        if (record.op == Op::ActionGroupAddAction)
+            actionGroup->addAction(action);
+        else
+            actionGroup->removeAction(action);
+        return true;
+    }
+    case Op::ActionGroupClear: actionGroup->clear(); return true;
+    case Op::ActionGroupSetEnabled: actionGroup->setEnabled(args.at(0).toBool()); return true;
+    case Op::ActionGroupSetExclusive: actionGroup->setExclusive(args.at(0).toBool()); return true;
+    case Op::ActionGroupSetCheckedIndex: actionGroup->setCheckedIndex(args.at(0).toLongLong()); return true;
+    default: Q_UNREACHABLE();
+    }
+}
+
+void Replayer::destroyAll()
+{
+    // Deleting a parent clears the pointers to its children
+    for (const auto& object : std::as_const(m_objects))
+        delete object.data();
+
+    m_objects.clear();
+}
+
+bool replay(QFile& file, QObject* rootItem, Stats& stats)
+{
+    file.seek(0);
+
+    PlatformAgnosticTrace::Reader reader(&file);
+    if (!reader.isValid())
+        return false;
+
+    Replayer replayer(rootItem);
+    QElapsedTimer timer;
+    Record record;
+
+    while (reader.readNext(record))
+    {
+        auto& op = stats[size_t(record.op)];
+
+        timer.start();
+        const bool applied = replayer.apply(record);
+        const qint64 elapsed = timer.nsecsElapsed();
+
+        ++op.count;
+        op.recorded += record.duration;
+        if (applied)
+            op.replayed += elapsed;
+        else
+            ++op.skipped;
+
+        // Runs the deferred work the recorded program ran between its calls
+        QCoreApplication::processEvents();
+    }
+
+    return true;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Replays a PlatformAgnosticTrace log"));
+    parser.addHelpOption();
+    parser.addPositionalArgument(QStringLiteral("trace"), QStringLiteral("The log to replay"));
+    parser.addOption({QStringLiteral("backend"), QStringLiteral("widgets, quick or null, widgets by default"),
+                      QStringLiteral("backend"), QStringLiteral("widgets")});
+    parser.addOption({QStringLiteral("repeat"), QStringLiteral("Replays the log n times"),
+                      QStringLiteral("n"), QStringLiteral("1")});
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1)
+        parser.showHelp(1);
+
+    QFile file(parser.positionalArguments().constFirst());
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        std::fprintf(stderr, "%s\n", qPrintable(file.errorString()));
+        return 1;
+    }
+
+    const QString backend = parser.value(QStringLiteral("backend"));
+    const int repeat = qMax(1, parser.value(QStringLiteral("repeat")).toInt());
+
+    QQuickWindow window;
+    QQmlEngine engine;
+    std::unique_ptr<QQuickItem> rootItem;
+
+    if (backend == QLatin1String("widgets"))
+    {
+        PlatformAgnosticMenu::setDefaultBackend(PlatformAgnosticMenu::Backend::Widgets);
+    }
+    else if (backend == QLatin1String("null"))
+    {
+        PlatformAgnosticMenu::setDefaultBackend(PlatformAgnosticMenu::Backend::Null);
+    }
+    else if (backend == QLatin1String("quick"))
+    {
+        // QuickControls2Menu needs a parent item with an engine associated to its context
+        QQmlComponent component(&engine);
+        component.setData("import QtQuick 2.12\nItem {}", QUrl());
+        rootItem.reset(qobject_cast<QQuickItem*>(component.create()));
+        if (!rootItem)
+        {
+            std::fprintf(stderr, "%s\n", qPrintable(component.errorString()));
+            return 1;
+        }
+
+        window.resize(640, 480);
+        rootItem->setParentItem(window.contentItem());
+        rootItem->setSize(window.size());
+        window.show();
+    }
+    else
+    {
+        std::fprintf(stderr, "Unknown backend %s\n", qPrintable(backend));
+        return 1;
+    }
+
+    Stats stats;
+    for (int i = 0; i < repeat; ++i)
+    {
+        if (!replay(file, rootItem.get(), stats))
+        {
+            std::fprintf(stderr, "%s is not a trace\n", qPrintable(file.fileName()));
+            return 1;
+        }
+    }
+
+    QTextStream out(stdout);
+    out << "backend: " << backend << ", runs: " << repeat << '\n';
+    out << qSetFieldWidth(28) << Qt::left << "op" << qSetFieldWidth(10) << Qt::right
+        << "count" << "skipped" << "recorded" << "replayed" << qSetFieldWidth(0) << " (ms)\n";
+
+    OpStats total;
+    for (size_t i = 0; i < stats.size(); ++i)
+    {
+        const auto& op = stats[i];
+        if (!op.count)
+            continue;
+
+        out << qSetFieldWidth(28) << Qt::left << PlatformAgnosticTrace::opName(Op(i))
+            << qSetFieldWidth(10) << Qt::right << op.count << op.skipped
+            << op.recorded / 1e6 << op.replayed / 1e6 << qSetFieldWidth(0) << '\n';
+
+        total.count += op.count;
+        total.skipped += op.skipped;
+        total.recorded += op.recorded;
+        total.replayed += op.replayed;
+    }
+
+    out << qSetFieldWidth(28) << Qt::left << "total"
+        << qSetFieldWidth(10) << Qt::right << total.count << total.skipped
+        << total.recorded / 1e6 << total.replayed / 1e6 << qSetFieldWidth(0) << '\n';
+
+    return 0;
+}
@@ -0,0 +1,182 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QTextStream>
+
+#include <cstdio>
+
+#if defined(Q_OS_LINUX)
+#include <ctime>
+#include <unistd.h>
+#endif
+
+#include "platformagnosticmenus.hpp"
+
+#if defined(PLATFORMAGNOSTICMENUS_WIDGETS)
+#include <QApplication>
+#else
+#include <QGuiApplication>
+#include <QQmlEngine>
+#include <QQmlComponent>
+#include <QQuickItem>
+#include <memory>
+#endif
+
+// Startup cost of one library configuration, built once per backend target.
+// The process start to main() time covers loading and relocating the Qt libraries,
+// it has the resolution of the scheduler clock. Run with QT_QPA_PLATFORM=offscreen.
+
+namespace
+{
+
+#if defined(Q_OS_LINUX)
+double processStartToNowMs()
+{
+    QFile file(QStringLiteral("/proc/self/stat"));
+    if (!file.open(QIODevice::ReadOnly))
+        return -1;
+
+    // The command name may contain spaces, the fields are counted after it
+    const QByteArray stat = file.readAll();
+    const auto fields = stat.mid(stat.lastIndexOf(')') + 2).split(' ');
+    if (fields.size() < 20)
+        return -1;
+
+    // Field 22 of the file, the start time in clock ticks after boot
+    const double startMs = fields.at(19).toDouble() * 1000.0 / sysconf(_SC_CLK_TCK);
+
+    timespec now;
+    clock_gettime(CLOCK_BOOTTIME, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1e6 - startMs;
+}
+
+QByteArray statusField(const QByteArray& name)
+{
+    QFile file(QStringLiteral("/proc/self/status"));
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    const auto lines = file.readAll().split('\n');
+    for (const auto& line : lines)
+    {
+        if (line.startsWith(name + ':'))
+            return line.mid(name.size() + 1).trimmed();
+    }
+
+    return {};
+}
+
+QStringList loadedQtLibraries()
+{
+    QFile file(QStringLiteral("/proc/self/maps"));
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    QSet<QString> libraries;
+    const auto lines = file.readAll().split('\n');
+    for (const auto& line : lines)
+    {
+        const int pos = line.indexOf('/');
+        if (pos >= 0 && line.contains("libQt6"))
+            libraries.insert(QFileInfo(QString::fromLocal8Bit(line.mid(pos))).fileName());
+    }
+
+    QStringList list{libraries.cbegin(), libraries.cend()};
+    list.sort();
+    return list;
+}
+#endif
+
+const char* configuration()
+{
+#if defined(PLATFORMAGNOSTICMENUS_WIDGETS) && defined(PLATFORMAGNOSTICMENUS_QUICKCONTROLS2)
+    return "widgets+quickcontrols2, Widgets menu";
+#elif defined(PLATFORMAGNOSTICMENUS_WIDGETS)
+    return "widgets";
+#else
+    return "quickcontrols2";
+#endif
+}
+
+void populate(PlatformAgnosticMenu* menu)
+{
+    for (int i = 0; i < 20; ++i)
+        menu->addAction(QStringLiteral("Action %1").arg(i));
+
+    // Lays the menu out, as showing it would
+    menu->sizeHint();
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+#if defined(Q_OS_LINUX)
+    const double startToMainMs = processStartToNowMs();
+#endif
+
+    QElapsedTimer timer;
+    timer.start();
+
+#if defined(PLATFORMAGNOSTICMENUS_WIDGETS)
+    QApplication app(argc, argv);
+
+    const auto menu = PlatformAgnosticMenu::createMenu();
+#else
+    QGuiApplication app(argc, argv);
+
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData("import QtQuick 2.12\nItem {}", QUrl());
+    const std::unique_ptr<QObject> rootItem{component.create()};
+    if (!rootItem)
+    {
+        std::fprintf(stderr, "%s\n", qPrintable(component.errorString()));
+        return 1;
+    }
+
+    const auto menu = PlatformAgnosticMenu::createMenu(rootItem.get());
+#endif
+
+    populate(menu);
+
+    const double mainToMenuMs = timer.nsecsElapsed() / 1e6;
+
+    QTextStream out(stdout);
+    out << "configuration: " << configuration() << '\n';
+#if defined(Q_OS_LINUX)
+    out << "process start to main: " << startToMainMs << " ms\n";
+#endif
+    out << "main to first menu: " << mainToMenuMs << " ms\n";
+#if defined(Q_OS_LINUX)
+    out << "VmRSS: " << statusField("VmRSS") << '\n';
+    out << "VmHWM: " << statusField("VmHWM") << '\n';
+    out << "Qt libraries: " << loadedQtLibraries().join(QLatin1Char(' ')) << '\n';
+#endif
+
+    delete menu;
+    return 0;
+}
@@ -0,0 +1,253 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "platformagnosticaccounting.hpp"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QIODevice>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QPointer>
+#include <QTimer>
+
+#include <cassert>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "platformagnosticmenu.hpp"
+#include "platformagnosticaction.hpp"
+#include "platformagnosticactiongroup.hpp"
+
+namespace
+{
+
+using PlatformAgnosticAccounting::Counts;
+
+struct State
+{
+    // Guards the list, the objects may be created on other threads
+    QMutex mutex;
+    PlatformAgnosticAccounting::Entry* head = nullptr;
+
+    qint64 (*qmlComponentCounter)() = nullptr;
+
+    QPointer<QIODevice> device;
+    // Owned by the application, which may be destroyed before the state
+    QPointer<QTimer> timer;
+};
+
+State& state()
+{
+    static State s;
+    return s;
+}
+
+QJsonObject countsToJson(const Counts& counts)
+{
+    return {
+        {QStringLiteral("menus"), counts.menus},
+        {QStringLiteral("actions"), counts.actions},
+        {QStringLiteral("lazyActions"), counts.lazyActions},
+        {QStringLiteral("actionGroups"), counts.actionGroups},
+        {QStringLiteral("nativeObjects"), counts.nativeObjects},
+        {QStringLiteral("separators"), counts.separators},
+        {QStringLiteral("bytes"), counts.bytes}
+    };
+}
+
+void exportSnapshot()
+{
+    auto& s = state();
+
+    if (s.device)
+        s.device->write(PlatformAgnosticAccounting::snapshot().toJson() + '\n');
+}
+
+}
+
+PlatformAgnosticAccounting::Entry::Entry(QObject *object) :
+    m_object(object)
+{
+    auto& s = state();
+    const QMutexLocker locker(&s.mutex);
+
+    m_next = s.head;
+    if (m_next)
+        m_next->m_previous = this;
+    s.head = this;
+}
+
+PlatformAgnosticAccounting::Entry::~Entry()
+{
+    auto& s = state();
+    const QMutexLocker locker(&s.mutex);
+
+    if (m_previous)
+        m_previous->m_next = m_next;
+    else
+        s.head = m_next;
+
+    if (m_next)
+        m_next->m_previous = m_previous;
+}
+
+PlatformAgnosticAccounting::Counts &PlatformAgnosticAccounting::Counts::operator+=(const Counts &other)
+{
+    menus += other.menus;
+    actions += other.actions;
+    lazyActions += other.lazyActions;
+    actionGroups += other.actionGroups;
+    nativeObjects += other.nativeObjects;
+    separators += other.separators;
+    bytes += other.bytes;
+    return *this;
+}
+
+PlatformAgnosticAccounting::Counts PlatformAgnosticAccounting::Snapshot::total() const
+{
+    Counts counts;
+    for (const auto& backend : backends)
+        counts += backend;
+    return counts;
+}
+
+QByteArray PlatformAgnosticAccounting::Snapshot::toJson() const
+{
+    using Backend = PlatformAgnosticMenu::Backend;
+
+    const QJsonObject backendObject{
+        {QStringLiteral("widgets"), countsToJson(backends[static_cast<size_t>(Backend::Widgets)])},
+        {QStringLiteral("quickcontrols2"), countsToJson(backends[static_cast<size_t>(Backend::QuickControls2)])},
+        {QStringLiteral("null"), countsToJson(backends[static_cast<size_t>(Backend::Null)])}
+    };
+
+    const QJsonObject object{
+        {QStringLiteral("timestamp"), timestamp},
+        {QStringLiteral("backends"), backendObject},
+        {QStringLiteral("total"), countsToJson(total())},
+        {QStringLiteral("qmlComponents"), qmlComponents},
+        {QStringLiteral("heapBytes"), heapBytes}
+    };
+
+    return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
+
+PlatformAgnosticAccounting::Snapshot PlatformAgnosticAccounting::snapshot()
+{
+    auto& s = state();
+
+    Snapshot snapshot;
+    snapshot.timestamp = QDateTime::currentMSecsSinceEpoch();
+
+    {
+        const QMutexLocker locker(&s.mutex);
+
+        for (const Entry* entry = s.head; entry; entry = entry->m_next)
+        {
+            Usage usage;
+            Counts counts;
+
+            if (const auto menu = qobject_cast<const PlatformAgnosticMenu*>(entry->m_object))
+            {
+                usage = menu->usage();
+                counts.menus = 1;
+            }
+            else if (const auto action = qobject_cast<const PlatformAgnosticAction*>(entry->m_object))
+            {
+                usage = action->usage();
+                counts.actions = 1;
+                counts.lazyActions = usage.lazy;
+            }
+            else if (const auto actionGroup = qobject_cast<const PlatformAgnosticActionGroup*>(entry->m_object))
+            {
+                usage = actionGroup->usage();
+                counts.actionGroups = 1;
+            }
+
+            // Objects still in their constructor do not know their backend yet
+            if (usage.backend < 0 || usage.backend >= int(snapshot.backends.size()))
+                continue;
+
+            counts.nativeObjects = usage.nativeObjects;
+            counts.separators = usage.separators;
+            counts.bytes = usage.bytes;
+            snapshot.backends[size_t(usage.backend)] += counts;
+        }
+    }
+
+    if (s.qmlComponentCounter)
+        snapshot.qmlComponents = s.qmlComponentCounter();
+
+    snapshot.heapBytes = heapBytes();
+    return snapshot;
+}
+
+bool PlatformAgnosticAccounting::startExport(QIODevice *device, const std::chrono::milliseconds interval)
+{
+    assert(device);
+
+    if (!device->isWritable())
+        return false;
+
+    auto& s = state();
+    s.device = device;
+
+    if (!s.timer)
+    {
+        assert(QCoreApplication::instance());
+        s.timer = new QTimer(QCoreApplication::instance());
+        QObject::connect(s.timer, &QTimer::timeout, &exportSnapshot);
+    }
+
+    // The first snapshot is the baseline
+    exportSnapshot();
+    s.timer->start(interval);
+    return true;
+}
+
+void PlatformAgnosticAccounting::stopExport()
+{
+    auto& s = state();
+
+    if (s.timer)
+        s.timer->stop();
+    s.device = nullptr;
+}
+
+qint64 PlatformAgnosticAccounting::heapBytes()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    const auto info = mallinfo2();
+    return static_cast<qint64>(info.uordblks + info.hblkhd);
+#else
+    return -1;
+#endif
+}
+
+void PlatformAgnosticAccounting::registerQmlComponentCounter(qint64 (*counter)())
+{
+    state().qmlComponentCounter = counter;
+}
@@ -0,0 +1,116 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef PLATFORMAGNOSTICACCOUNTING_HPP
+#define PLATFORMAGNOSTICACCOUNTING_HPP
+
+#include <QtGlobal>
+#include <QByteArray>
+
+#include <array>
+#include <chrono>
+
+class QObject;
+class QIODevice;
+
+// Keeps track of the live menus, actions and action groups, to find leaked wrappers
+// and follow the memory growth of long running sessions. The objects are linked
+// into a list when they are created, and a snapshot adds up what each one holds.
+// Snapshots are taken on the thread the objects live on.
+namespace PlatformAgnosticAccounting
+{
+    // What one object holds, reported by its usage() method
+    struct Usage
+    {
+        // A PlatformAgnosticMenu::Backend
+        int backend = -1;
+        bool lazy = false;
+        // The native menus, actions, action groups and separators the object owns
+        int nativeObjects = 0;
+        // The separators of a menu, which are native objects except for the null backend
+        int separators = 0;
+        // The object and what it allocates itself, without the allocations of Qt
+        qint64 bytes = 0;
+    };
+
+    struct Counts
+    {
+        qint64 menus = 0;
+        qint64 actions = 0;
+        qint64 lazyActions = 0;
+        qint64 actionGroups = 0;
+        qint64 nativeObjects = 0;
+        qint64 separators = 0;
+        qint64 bytes = 0;
+
+        Counts& operator+=(const Counts& other);
+    };
+
+    struct Snapshot
+    {
+        // Milliseconds since the epoch
+        qint64 timestamp = 0;
+        // Indexed by PlatformAgnosticMenu::Backend
+        std::array<Counts, 3> backends;
+        // The QQmlComponents the Qt Quick backend holds, they are shared per engine
+        qint64 qmlComponents = 0;
+        // The bytes in use on the heap of the process, -1 if the platform can not tell
+        qint64 heapBytes = -1;
+
+        Counts total() const;
+        // A single line of JSON
+        QByteArray toJson() const;
+    };
+
+    Snapshot snapshot();
+
+    // Writes a snapshot to the device every interval, one line each. The device must
+    // stay open until stopExport(). Returns false if it is not writable.
+    bool startExport(QIODevice* device, std::chrono::milliseconds interval);
+    void stopExport();
+
+    // The bytes in use on the heap, or -1 if the platform can not tell
+    qint64 heapBytes();
+
+    // Called by the Qt Quick backend, so that the core does not depend on Qt Qml
+    void registerQmlComponentCounter(qint64 (*counter)());
+
+    // A member of the base classes, which links the object into the list of live objects
+    class Entry
+    {
+    public:
+        explicit Entry(QObject* object);
+        ~Entry();
+
+        Entry(const Entry&) = delete;
+        Entry& operator=(const Entry&) = delete;
+
+    private:
+        friend Snapshot snapshot();
+
+        QObject* m_object;
+        Entry* m_previous = nullptr;
+        Entry* m_next = nullptr;
+    };
+}
+
+#endif // PLATFORMAGNOSTICACCOUNTING_HPP
@@ -24,18 +24,14 @@
  */
 #include "platformagnosticaction.hpp"
 
-#include <QAction>
-#include <QQmlComponent>
-#include <QQmlProperty>
-#include <QQuickItem>
-#include <QQmlEngine>
-#include <QQmlFile>
-#include <QIcon>
+#include <QMetaMethod>
 
 #include "platformagnosticactiongroup.hpp"
 #include "platformagnosticmenu.hpp"
+#include "platformagnosticbackend.hpp"
+#include "platformagnostictrace.hpp"
 
-#define QQUICKCONTROLS2_ACTION_PATH "qrc:///util/ActionExt.qml"
+#include <utility>
 
 PlatformAgnosticAction::PlatformAgnosticAction(QObject *parent)
     : QObject{parent}
@@ -43,21 +39,54 @@ PlatformAgnosticAction::PlatformAgnosticAction(QObject *parent)
 
 }
 
-template<>
-PlatformAgnosticAction* PlatformAgnosticAction::fromAction(QAction *action)
+PlatformAgnosticAction::~PlatformAgnosticAction()
 {
-    assert(action);
+    PLATFORMAGNOSTIC_TRACE(Destroy, this);
+
+    // The menus drop the action from their indexes, which edits m_menus
+    while (!m_menus.isEmpty())
+        m_menus.last()->onActionDestroyed(this);
+
+    if (m_group)
+        m_group->actionRemoved(this);
+}
+
+void PlatformAgnosticAction::joinActionGroup(PlatformAgnosticActionGroup *actionGroup)
+{
+    if (m_group == actionGroup)
+        return;
+
+    if (m_group)
+        m_group->actionRemoved(this);
+
+    m_group = actionGroup;
 
-    PlatformAgnosticAction* const widgetsAction = new WidgetsAction;
+    if (m_group)
+        m_group->actionAdded(this);
+}
 
-    widgetsAction->setAction(action);
+void PlatformAgnosticAction::connectNotify(const QMetaMethod &signal)
+{
+    if (m_relaySignals)
+        return;
+
+    if (signal == QMetaMethod::fromSignal(&PlatformAgnosticAction::triggered) ||
+        signal == QMetaMethod::fromSignal(&PlatformAgnosticAction::toggled))
+    {
+        relayNativeSignals();
+    }
+}
 
-    connect(action, &QAction::toggled, widgetsAction, &PlatformAgnosticAction::toggled);
-    connect(action, &QAction::triggered, widgetsAction, &PlatformAgnosticAction::triggered);
+void PlatformAgnosticAction::relayNativeSignals()
+{
+    if (m_relaySignals)
+        return;
 
-    action->setProperty("platformAgnosticAction", QVariant::fromValue(widgetsAction));
+    m_relaySignals = true;
 
-    return widgetsAction;
+    // Lazy actions connect once their native action is created
+    if (action())
+        connectNativeSignals();
 }
 
 template<>
@@ -69,25 +98,7 @@ PlatformAgnosticAction* PlatformAgnosticAction::fromAction(PlatformAgnosticActio
 
 PlatformAgnosticAction *PlatformAgnosticAction::createAction(QObject *parent)
 {
-    if (!parent)
-    {
-        return new WidgetsAction;
-    }
-    else
-    {
-        if (const auto widgetsMenuParent = qobject_cast<WidgetsMenu*>(parent))
-            return new WidgetsAction(widgetsMenuParent);
-        else if (const auto quickControls2MenuParent = qobject_cast<QuickControls2Menu*>(parent))
-            return new QuickControls2Action((*quickControls2MenuParent)(), quickControls2MenuParent);
-        else if (const auto widgetsActionGroupParent = qobject_cast<WidgetsActionGroup*>(parent))
-            return new WidgetsAction(widgetsActionGroupParent);
-        else if (const auto quickControls2ActionGroupParent = qobject_cast<QuickControls2ActionGroup*>(parent))
-            return new QuickControls2Action((*quickControls2ActionGroupParent)(), quickControls2ActionGroupParent);
-        else if (const auto quickItemParent = qobject_cast<QQuickItem*>(parent))
-            return new QuickControls2Action(quickItemParent, quickItemParent);
-        else
-            Q_UNREACHABLE();
-    }
+    return PlatformAgnosticBackend::createAction(parent, false);
 }
 
 PlatformAgnosticAction *PlatformAgnosticAction::createAction(const QString& text, QObject *parent)
@@ -97,241 +108,352 @@ PlatformAgnosticAction *PlatformAgnosticAction::createAction(const QString& text
     return action;
 }
 
-void PlatformAgnosticAction::setVisible(const bool _visible)
+PlatformAgnosticAction *PlatformAgnosticAction::createLazyAction(QObject *parent)
 {
-    if (isVisible() == _visible)
-        return;
-
-    if (_visible)
-    {
-        const auto text = m_text;
-        m_text.clear();
-        setText(text);
-    }
-    else
-    {
-        m_text = text();
-        setText(QLatin1String(""));
-    }
+    return PlatformAgnosticBackend::createAction(parent, true);
 }
 
-bool PlatformAgnosticAction::isVisible() const
+PlatformAgnosticAction *PlatformAgnosticAction::createLazyAction(const QString& text, QObject *parent)
 {
-    return m_text.isEmpty();
+    PlatformAgnosticAction * const action = createLazyAction(parent);
+    action->setText(text);
+    return action;
 }
 
-QString PlatformAgnosticAction::text() const
+void PlatformAgnosticAction::materialize()
 {
+    if (!m_lazyState)
+        return;
+
+    createNativeAction();
     assert(action());
-    return action()->property("text").value<QString>();
+
+    if (m_relaySignals)
+        connectNativeSignals();
+
+    // From now on the setters write to the native action
+    const std::unique_ptr<LazyState> state = std::move(m_lazyState);
+
+    setCheckable(state->checkable);
+    setChecked(state->checked);
+    setEnabled(state->enabled);
+    // Not through setText(), which would store the text of a hidden action in m_text
+    setNativeText(state->text);
+
+    if (!state->shortcut.isEmpty())
+        setShortcut(state->shortcut);
+    if (!state->icon.isEmpty())
+        setIcon(state->icon, state->iconIsSource);
+    if (state->actionGroup)
+        setActionGroup(state->actionGroup);
+    if (m_filteredOut)
+        setFilteredOut(true);
 }
 
-void PlatformAgnosticAction::setText(const QString &text)
+void PlatformAgnosticAction::materializeInMenus()
 {
-    assert(action());
-    if (isVisible())
-        action()->setProperty("text", text);
-    else
-        m_text = text;
+    // Keeps the order of the native menus
+    const auto menus = m_menus;
+    for (const auto menu : menus)
+        menu->materializePendingActionsUntil(this);
+
+    materialize();
 }
 
-void PlatformAgnosticAction::setEnabled(bool enabled)
+bool PlatformAgnosticAction::dematerialize()
 {
+    if (m_lazyState || !m_ownsNativeAction || m_group || m_menus.size() > 1)
+        return false;
+
     assert(action());
-    action()->setProperty("enabled", enabled);
+
+    // A shortcut only works while its native action exists
+    if (!nativeShortcut().isEmpty())
+        return false;
+
+    // The native text is empty for a hidden action, as it is in LazyState
+    std::unique_ptr<LazyState> state{new LazyState{nativeText(),
+                                                   {},
+                                                   {},
+                                                   {},
+                                                   {},
+                                                   nativeEnabled(),
+                                                   nativeCheckable(),
+                                                   nativeChecked(),
+                                                   true}};
+
+    destroyNativeAction(*state);
+    assert(!action());
+
+    m_ownsNativeAction = false;
+    m_lazyState = std::move(state);
+    return true;
 }
 
-void PlatformAgnosticAction::setChecked(bool checked)
+PlatformAgnosticAccounting::Usage PlatformAgnosticAction::usage() const
 {
-    assert(action());
-    action()->setProperty("checked", checked);
+    PlatformAgnosticAccounting::Usage usage;
+    usage.lazy = isLazy();
+    usage.bytes = sizeof(PlatformAgnosticAction) + m_text.capacity() * sizeof(QChar);
+
+    if (m_lazyState)
+        usage.bytes += sizeof(LazyState) + m_lazyState->text.capacity() * sizeof(QChar);
+    if (m_stateProviders)
+        usage.bytes += sizeof(StateProviders);
+
+    return usage;
 }
 
-void PlatformAgnosticAction::setCheckable(bool checkable)
+void PlatformAgnosticAction::setVisible(const bool _visible)
 {
-    assert(action());
-    action()->setProperty("checkable", checkable);
+    PLATFORMAGNOSTIC_TRACE(ActionSetVisible, this, _visible);
+
+    if (isVisible() == _visible)
+        return;
+
+    // The text is not changed from the point of view of the menus, so the native
+    // text is written directly instead of going through setText()
+    QString nativeText;
+    if (_visible)
+        nativeText = std::exchange(m_text, QString());
+    else
+        m_text = text();
+
+    if (m_lazyState)
+        m_lazyState->text = nativeText;
+    else
+        setNativeText(nativeText);
+
+    for (const auto menu : std::as_const(m_menus))
+        menu->onActionVisibleChanged(this, _visible);
 }
 
-void PlatformAgnosticAction::setData(const QVariant &data)
+bool PlatformAgnosticAction::isVisible() const
 {
-    if (m_data != data)
-        m_data = data;
+    return m_text.isEmpty();
 }
 
-QVariant PlatformAgnosticAction::data() const
+QString PlatformAgnosticAction::text() const
 {
-    return m_data;
+    if (m_lazyState)
+        return m_lazyState->text;
+
+    return nativeText();
 }
 
-WidgetsAction::WidgetsAction(QObject *parent)
-    : PlatformAgnosticAction{parent}
+void PlatformAgnosticAction::setText(const QString &text)
 {
-    const auto action = new QAction(parent);
-    m_action = action;
+    PLATFORMAGNOSTIC_TRACE(ActionSetText, this, text);
 
-    connect(action, &QAction::changed, action, [action]() {
-        if (action->text().isEmpty())
-            action->setVisible(false);
-        else
-            action->setVisible(true);
-    });
+    if (!isVisible())
+        m_text = text;
+    else if (m_lazyState)
+        m_lazyState->text = text;
+    else
+        setNativeText(text);
 
-    connect(action, &QAction::toggled, this, &PlatformAgnosticAction::toggled);
-    connect(action, &QAction::triggered, this, &PlatformAgnosticAction::triggered);
+    for (const auto menu : std::as_const(m_menus))
+        menu->onActionTextChanged(this, text);
 
-    m_action->setProperty("platformAgnosticAction", QVariant::fromValue(this));
+    emit textChanged(text);
 }
 
-void WidgetsAction::setShortcut(const QKeySequence &shortcut)
+void PlatformAgnosticAction::setFilteredOut(const bool filteredOut)
 {
-    assert(m_action);
-    m_action->setShortcut(shortcut);
+    m_filteredOut = filteredOut;
 }
 
-void WidgetsAction::setActionGroup(PlatformAgnosticActionGroup *actionGroup)
+void PlatformAgnosticAction::setEnabled(bool enabled)
 {
-    assert(actionGroup ? !!qobject_cast<WidgetsActionGroup*>(actionGroup) : true);
-    assert(m_action);
+    PLATFORMAGNOSTIC_TRACE(ActionSetEnabled, this, enabled);
+
+    if (m_lazyState)
+    {
+        m_lazyState->enabled = enabled;
+        return;
+    }
 
-    m_action->setActionGroup(static_cast<WidgetsActionGroup*>(actionGroup)->m_actionGroup);
+    setNativeEnabled(enabled);
 }
 
-void WidgetsAction::setIcon(const QString &iconSourceOrName, const bool isSource)
+void PlatformAgnosticAction::setChecked(bool checked)
 {
-    assert(m_action);
+    PLATFORMAGNOSTIC_TRACE(ActionSetChecked, this, checked);
 
-    QIcon icon;
-    if (isSource)
+    if (m_lazyState)
     {
-        icon = QIcon(iconSourceOrName);
+        m_lazyState->checked = checked;
+        return;
     }
-    else
+
+    setNativeChecked(checked);
+}
+
+void PlatformAgnosticAction::setCheckable(bool checkable)
+{
+    PLATFORMAGNOSTIC_TRACE(ActionSetCheckable, this, checkable);
+
+    if (m_lazyState)
     {
-        assert(QIcon::hasThemeIcon(iconSourceOrName));
-        icon = QIcon::fromTheme(iconSourceOrName);
+        m_lazyState->checkable = checkable;
+        return;
     }
-    assert(!icon.isNull());
 
-    m_action->setIcon(icon);
+    setNativeCheckable(checkable);
 }
 
-QObject *WidgetsAction::action() const
+bool PlatformAgnosticAction::isEnabled() const
 {
-    return m_action.data();
+    return m_lazyState ? bool(m_lazyState->enabled) : nativeEnabled();
 }
 
-void WidgetsAction::setAction(QObject *action)
+bool PlatformAgnosticAction::isCheckable() const
 {
-    assert(action);
-    assert(qobject_cast<QAction*>(action));
-
-    m_action = static_cast<QAction*>(action);
+    return m_lazyState ? bool(m_lazyState->checkable) : nativeCheckable();
 }
 
-QuickControls2Action::QuickControls2Action(QObject *quickParent, QObject *parent)
-    : PlatformAgnosticAction{parent}
+bool PlatformAgnosticAction::isChecked() const
 {
-    assert(quickParent);
+    return m_lazyState ? bool(m_lazyState->checked) : nativeChecked();
+}
 
-    const auto engine = qmlEngine(quickParent);
-    assert(engine);
+QString PlatformAgnosticAction::nativeText() const
+{
+    assert(action());
+    return action()->property("text").toString();
+}
 
-    m_actionComponent = new QQmlComponent(engine, QUrl(QStringLiteral(QQUICKCONTROLS2_ACTION_PATH)), this);
+void PlatformAgnosticAction::setNativeText(const QString &text)
+{
+    assert(action());
+    action()->setProperty("text", text);
+}
 
-    m_action = m_actionComponent->create(qmlContext(quickParent));
-    assert(m_action);
-    assert(m_action->inherits("QQuickAction"));
+bool PlatformAgnosticAction::nativeEnabled() const
+{
+    assert(action());
+    return action()->property("enabled").toBool();
+}
 
-    QQmlEngine::setObjectOwnership(m_action, QQmlEngine::CppOwnership);
+void PlatformAgnosticAction::setNativeEnabled(const bool enabled)
+{
+    assert(action());
+    action()->setProperty("enabled", enabled);
+}
 
-    m_action->setParent(this);
+bool PlatformAgnosticAction::nativeCheckable() const
+{
+    assert(action());
+    return action()->property("checkable").toBool();
+}
 
-    connect(m_action, SIGNAL(toggled(QObject*)), this, SLOT(onToggled(QObject*)));
-    connect(m_action, SIGNAL(triggered(QObject*)), this, SLOT(onTriggered(QObject*)));
+void PlatformAgnosticAction::setNativeCheckable(const bool checkable)
+{
+    assert(action());
+    action()->setProperty("checkable", checkable);
+}
 
-    m_action->setProperty("platformAgnosticAction", QVariant::fromValue(this));
+bool PlatformAgnosticAction::nativeChecked() const
+{
+    assert(action());
+    return action()->property("checked").toBool();
 }
 
-QuickControls2Action::QuickControls2Action(QObject *parent)
-    : QuickControls2Action{parent, parent}
+void PlatformAgnosticAction::setNativeChecked(const bool checked)
 {
+    assert(action());
+    action()->setProperty("checked", checked);
+}
 
+QKeySequence PlatformAgnosticAction::nativeShortcut() const
+{
+    assert(action());
+    return action()->property("shortcut").value<QKeySequence>();
 }
 
-void QuickControls2Action::setShortcut(const QKeySequence &shortcut)
+void PlatformAgnosticAction::setData(const QVariant &data)
 {
-    assert(m_action);
+    if (m_data != data)
+        m_data = data;
+}
 
-    const bool ret = QQmlProperty::write(m_action.data(),
-                                         QStringLiteral("shortcut"),
-                                         shortcut);
-    assert(ret);
+QVariant PlatformAgnosticAction::data() const
+{
+    return m_data;
 }
 
-void QuickControls2Action::setActionGroup(PlatformAgnosticActionGroup *actionGroup)
+PlatformAgnosticAction::StateProviders &PlatformAgnosticAction::stateProviders()
 {
-    assert(actionGroup ? !!qobject_cast<QuickControls2ActionGroup*>(actionGroup) : true);
-    assert(m_action);
+    if (!m_stateProviders)
+        m_stateProviders.reset(new StateProviders);
+
+    return *m_stateProviders;
+}
 
-    const bool ret = QQmlProperty::write(m_action.data(),
-                                         QStringLiteral("ActionGroup.group"),
-                                         QVariant::fromValue(actionGroup ? static_cast<QuickControls2ActionGroup*>(actionGroup)->m_actionGroup.data()
-                                                                         : nullptr),
-                                         qmlContext(m_action.data()));
-    assert(ret);
+void PlatformAgnosticAction::setEnabledProvider(std::function<bool ()> provider)
+{
+    stateProviders().enabled = std::move(provider);
 }
 
-void QuickControls2Action::setIcon(const QString &_iconSourceOrName, const bool isSource)
+void PlatformAgnosticAction::setCheckedProvider(std::function<bool ()> provider)
 {
-    assert(m_action);
+    stateProviders().checked = std::move(provider);
+}
 
-    QString iconSourceOrName = _iconSourceOrName;
+void PlatformAgnosticAction::setTextProvider(std::function<QString ()> provider)
+{
+    stateProviders().text = std::move(provider);
+}
 
-    const QLatin1String suffixSource{"source"};
-    const QLatin1String suffixName{"name"};
-    const QLatin1String *suffix;
+bool PlatformAgnosticAction::evaluateStateProviders()
+{
+    assert(m_stateProviders);
+    auto& providers = *m_stateProviders;
 
-    if (isSource)
+    if (providers.text)
     {
-        const auto qrc = QLatin1String{"qrc"};
-        if (!iconSourceOrName.startsWith(qrc))
-            iconSourceOrName.prepend(qrc);
-
-        suffix = &suffixSource;
+        QString text = providers.text();
+        if (text != this->text())
+        {
+            providers.textValue = std::move(text);
+            providers.changes |= StateProviders::TextChange;
+        }
     }
-    else
+
+    if (providers.enabled)
     {
-        suffix = &suffixName;
+        const bool enabled = providers.enabled();
+        if (enabled != isEnabled())
+        {
+            providers.enabledValue = enabled;
+            providers.changes |= StateProviders::EnabledChange;
+        }
     }
 
-    auto property = QQmlProperty(m_action.data(), "icon." + *suffix, qmlContext(m_action.data()));
-    assert(property.isValid() && property.isWritable());
-    const bool ret = property.write(iconSourceOrName);
-    assert(ret);
-}
+    if (providers.checked)
+    {
+        const bool checked = providers.checked();
+        if (checked != isChecked())
+        {
+            providers.checkedValue = checked;
+            providers.changes |= StateProviders::CheckedChange;
+        }
+    }
 
-QObject *QuickControls2Action::action() const
-{
-    return m_action.data();
+    return providers.changes != 0;
 }
 
-void QuickControls2Action::setAction(QObject *action)
+void PlatformAgnosticAction::applyProvidedState()
 {
-    assert(action);
-    assert(action->inherits("QQuickAction"));
+    assert(m_stateProviders);
+    auto& providers = *m_stateProviders;
 
-    m_action = action;
-}
+    const int changes = std::exchange(providers.changes, 0);
 
-void QuickControls2Action::onTriggered(QObject *source)
-{
-    Q_UNUSED(source);
-    emit triggered(m_action->property("checked").toBool());
-}
-
-void QuickControls2Action::onToggled(QObject *source)
-{
-    Q_UNUSED(source);
-    emit toggled(m_action->property("toggled").toBool());
+    if (changes & StateProviders::TextChange)
+        setText(*providers.textValue);
+    if (changes & StateProviders::EnabledChange)
+        setEnabled(*providers.enabledValue);
+    if (changes & StateProviders::CheckedChange)
+        setChecked(*providers.checkedValue);
 }
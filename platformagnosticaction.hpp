@@ -28,8 +28,18 @@
 #include <QObject>
 #include <QPointer>
 #include <QVariant>
+#include <QVarLengthArray>
+#include <QKeySequence>
+
+#include <functional>
+#include <memory>
+#include <optional>
+
+#include "platformagnosticaccounting.hpp"
+#include "platformagnosticarena.hpp"
 
 class PlatformAgnosticActionGroup;
+class PlatformAgnosticMenu;
 
 // Common denominator for QAction and QQuickAction
 class PlatformAgnosticAction : public QObject
@@ -41,7 +51,10 @@ class PlatformAgnosticAction : public QObject
 
 public:
     explicit PlatformAgnosticAction(QObject *parent);
-    virtual ~PlatformAgnosticAction() = default;
+    virtual ~PlatformAgnosticAction();
+
+    static void* operator new(std::size_t size) { return PlatformAgnosticArena::allocate(size); }
+    static void operator delete(void* pointer) { PlatformAgnosticArena::deallocate(pointer); }
 
     template<class Action>
     static PlatformAgnosticAction* fromAction(Action action);
@@ -49,6 +62,15 @@ public:
     static PlatformAgnosticAction* createAction(QObject * parent = nullptr);
     static PlatformAgnosticAction* createAction(const QString& text, QObject * parent = nullptr);
 
+    // Lazy actions keep their state in a compact structure, and create
+    // the native action only when they are shown in a menu, added to an
+    // action group, or materialize() is called.
+    static PlatformAgnosticAction* createLazyAction(QObject * parent = nullptr);
+    static PlatformAgnosticAction* createLazyAction(const QString& text, QObject * parent = nullptr);
+
+    bool isLazy() const { return !!m_lazyState; }
+    void materialize();
+
     virtual void setVisible(const bool visible);
     virtual bool isVisible() const;
     virtual QString text() const;
@@ -60,6 +82,22 @@ public:
     virtual void setData(const QVariant& data);
     virtual QVariant data() const;
 
+    bool isEnabled() const;
+    bool isCheckable() const;
+    bool isChecked() const;
+
+    // Pulled when a menu the action is in is about to show, while the action is
+    // visible, instead of being pushed through the setters on every change.
+    // Also pulled when the action is shown or filtered in while the menu is open.
+    // A QProperty or a QBindable can be read from the callback.
+    void setEnabledProvider(std::function<bool()> provider);
+    void setCheckedProvider(std::function<bool()> provider);
+    void setTextProvider(std::function<QString()> provider);
+    bool hasStateProviders() const { return !!m_stateProviders; }
+
+    // What the action holds, for PlatformAgnosticAccounting::snapshot()
+    virtual PlatformAgnosticAccounting::Usage usage() const;
+
 public slots:
     virtual void setEnabled(bool enabled);
     virtual void setChecked(bool checked);
@@ -67,67 +105,119 @@ public slots:
 signals:
     void toggled(bool);
     void triggered(bool);
+    void textChanged(const QString& text);
 
 protected:
     QObject* operator()() const { return action(); };
     virtual QObject* action() const = 0;
     virtual void setAction(QObject* action) = 0;
+    virtual void createNativeAction() = 0;
+
+    // toggled() and triggered() are relayed from the native action only once something
+    // connects to them. Most actions are handled through PlatformAgnosticMenu::triggered().
+    void connectNotify(const QMetaMethod& signal) override;
+    virtual void connectNativeSignals() = 0;
+    // Relays them from now on, also called by the implementations that need them
+    void relayNativeSignals();
+
+    // Hides the action while its menu is filtered, independent of setVisible()
+    virtual void setFilteredOut(bool filteredOut);
+
+    // The state of the native action once it is materialized. The default implementations
+    // go through the properties of action(), which QAction and QQuickAction share.
+    virtual QString nativeText() const;
+    virtual void setNativeText(const QString& text);
+    virtual bool nativeEnabled() const;
+    virtual void setNativeEnabled(bool enabled);
+    virtual bool nativeCheckable() const;
+    virtual void setNativeCheckable(bool checkable);
+    virtual bool nativeChecked() const;
+    virtual void setNativeChecked(bool checked);
+    virtual QKeySequence nativeShortcut() const;
+
+    struct LazyState
+    {
+        QString text;
+        QString icon;
+        QKeySequence shortcut;
+        QPointer<QObject> quickParent;
+        QPointer<PlatformAgnosticActionGroup> actionGroup;
+        bool enabled : 1;
+        bool checkable : 1;
+        bool checked : 1;
+        bool iconIsSource : 1;
+
+        static void* operator new(std::size_t size) { return PlatformAgnosticArena::allocate(size); }
+        static void operator delete(void* pointer) { PlatformAgnosticArena::deallocate(pointer); }
+    };
+
+    // Only set while the native action is not created
+    std::unique_ptr<LazyState> m_lazyState;
+
+    // Materializes the action along with the pending entries before it in its menus,
+    // for the state that has to work while the menus are closed, such as shortcuts
+    void materializeInMenus();
+
+    // The opposite of materialize(), used by PlatformAgnosticMenu::hibernate().
+    // Returns false for actions that are wrapped, in an action group, in other menus,
+    // or that have a shortcut.
+    bool dematerialize();
+    // Fills the parts of state that only the backend knows, such as the icon,
+    // and destroys the native action created by createNativeAction()
+    virtual void destroyNativeAction(LazyState& state) = 0;
+    // Set by createNativeAction(), the native actions given to setAction() are not owned
+    bool m_ownsNativeAction = false;
 
     QVariant m_data;
+    // The text of a hidden action, whose native text is empty
     QString m_text;
-};
-
-class WidgetsAction : public PlatformAgnosticAction
-{
-    Q_OBJECT
-
-    friend class WidgetsActionGroup;
-    friend class WidgetsMenu;
-
-public:
-    WidgetsAction(QObject *parent = nullptr);
-    virtual ~WidgetsAction() = default;
-
-    void setShortcut(const QKeySequence &shortcut) override;
-    void setActionGroup(PlatformAgnosticActionGroup* actionGroup) override;
-    void setIcon(const QString& iconSourceOrName, bool isSource = true) override;
-
-protected:
-    QObject* action() const override;
-    void setAction(QObject* action) override;
-
-private:
-    QPointer<class QAction> m_action;
-};
-
-class QuickControls2Action : public PlatformAgnosticAction
-{
-    Q_OBJECT
-
-    friend class QuickControls2ActionGroup;
-    friend class QuickControls2Menu;
-
-public:
-    QuickControls2Action(QObject* quickParent, class QObject* parent = nullptr);
-
-    explicit QuickControls2Action(QObject *parent);
-    virtual ~QuickControls2Action() = default;
-
-    void setShortcut(const QKeySequence &shortcut) override;
-    void setActionGroup(PlatformAgnosticActionGroup* actionGroup) override;
-    void setIcon(const QString& iconSourceOrName, bool isSource = true) override;
-
-protected:
-    QObject* action() const override;
-    void setAction(QObject* action) override;
-
-private:
-    QPointer<QObject> m_action;
-    QPointer<class QQmlComponent> m_actionComponent;
-
-private slots:
-    void onTriggered(QObject* source);
-    void onToggled(QObject* source);
+    bool m_filteredOut = false;
+
+    // The text shown once the action is visible, for the text index of the menus
+    QString logicalText() const { return isVisible() ? text() : m_text; }
+    bool m_relaySignals = false;
+
+    struct StateProviders
+    {
+        enum Change
+        {
+            TextChange = 0x1,
+            EnabledChange = 0x2,
+            CheckedChange = 0x4
+        };
+
+        std::function<bool()> enabled;
+        std::function<bool()> checked;
+        std::function<QString()> text;
+
+        // The values that differ from the current state of the action, to be written
+        // by applyProvidedState(). Compared to the state rather than to the values
+        // written last, since the setters may have changed it in between.
+        std::optional<QString> textValue;
+        std::optional<bool> enabledValue;
+        std::optional<bool> checkedValue;
+        int changes = 0;
+
+        static void* operator new(std::size_t size) { return PlatformAgnosticArena::allocate(size); }
+        static void operator delete(void* pointer) { PlatformAgnosticArena::deallocate(pointer); }
+    };
+
+    // Created by the first provider
+    std::unique_ptr<StateProviders> m_stateProviders;
+    StateProviders& stateProviders();
+    // Called by PlatformAgnosticMenu, first for all the actions, then in a batch
+    bool evaluateStateProviders();
+    void applyProvidedState();
+
+    // Group this action is in, maintained through joinActionGroup()
+    PlatformAgnosticActionGroup* m_group = nullptr;
+    // Called by the implementations of setActionGroup()
+    void joinActionGroup(PlatformAgnosticActionGroup* actionGroup);
+
+    // Menus this action is in, maintained by PlatformAgnosticMenu
+    QVarLengthArray<PlatformAgnosticMenu*, 1> m_menus;
+
+    PlatformAgnosticAccounting::Entry m_accountingEntry{this};
 };
 
 #endif // PLATFORMAGNOSTICACTION_HPP
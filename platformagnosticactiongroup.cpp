@@ -24,14 +24,11 @@
  */
 #include "platformagnosticactiongroup.hpp"
 
-#include <QActionGroup>
-#include <QQuickItem>
-#include <QQmlComponent>
-#include <QQmlEngine>
+#include "platformagnosticaction.hpp"
+#include "platformagnosticbackend.hpp"
+#include "platformagnostictrace.hpp"
 
-#include "platformagnosticmenu.hpp"
-
-#define QQUICKCONTROLS2_ACTION_GROUP_PATH "qrc:///util/ActionGroupExt.qml"
+#include <utility>
 
 PlatformAgnosticActionGroup::PlatformAgnosticActionGroup(QObject *parent)
     : QObject{parent}
@@ -39,19 +36,12 @@ PlatformAgnosticActionGroup::PlatformAgnosticActionGroup(QObject *parent)
 
 }
 
-template<>
-PlatformAgnosticActionGroup* PlatformAgnosticActionGroup::fromActionGroup(QActionGroup * actionGroup)
+PlatformAgnosticActionGroup::~PlatformAgnosticActionGroup()
 {
-    assert(actionGroup);
-
-    PlatformAgnosticActionGroup* const widgetsActionGroup = new WidgetsActionGroup;
-
-    widgetsActionGroup->setActionGroup(actionGroup);
-
-    connect(actionGroup, &QActionGroup::triggered, widgetsActionGroup, &PlatformAgnosticActionGroup::triggered);
-    actionGroup->setProperty("platformAgnosticActionGroup", QVariant::fromValue(widgetsActionGroup));
+    PLATFORMAGNOSTIC_TRACE(Destroy, this);
 
-    return widgetsActionGroup;
+    for (const auto action : std::as_const(m_actions))
+        action->m_group = nullptr;
 }
 
 template<>
@@ -63,133 +53,107 @@ PlatformAgnosticActionGroup* PlatformAgnosticActionGroup::fromActionGroup(Platfo
 
 PlatformAgnosticActionGroup* PlatformAgnosticActionGroup::createActionGroup(QObject *parent)
 {
-    if (!parent)
-    {
-        return new WidgetsActionGroup;
-    }
-    else
-    {
-        if (const auto widgetsMenuParent = qobject_cast<WidgetsMenu*>(parent))
-            return new WidgetsActionGroup(widgetsMenuParent);
-        else if (const auto quickControls2MenuParent = qobject_cast<QuickControls2Menu*>(parent))
-            return new QuickControls2ActionGroup((*quickControls2MenuParent)(), quickControls2MenuParent);
-        else if (const auto quickItemParent = qobject_cast<QQuickItem*>(parent))
-            return new QuickControls2ActionGroup(quickItemParent, quickItemParent);
-        else
-            Q_UNREACHABLE();
-    }
+    return PlatformAgnosticBackend::createActionGroup(parent);
 }
 
-void PlatformAgnosticActionGroup::setEnabled(const bool enabled)
+void PlatformAgnosticActionGroup::addAction(PlatformAgnosticAction *action)
 {
-    assert(actionGroup());
-    actionGroup()->setProperty("enabled", enabled);
-}
+    PLATFORMAGNOSTIC_TRACE(ActionGroupAddAction, this, action);
 
-void PlatformAgnosticActionGroup::setExclusive(const bool exclusive)
-{
-    assert(actionGroup());
-    actionGroup()->setProperty("exclusive", exclusive);
+    assert(action);
+
+    action->materialize();
+    action->setActionGroup(this);
 }
 
-WidgetsActionGroup::WidgetsActionGroup(QObject *parent)
-    : PlatformAgnosticActionGroup{parent}
+void PlatformAgnosticActionGroup::removeAction(PlatformAgnosticAction *action)
 {
-    m_actionGroup = new QActionGroup(parent);
-    connect(m_actionGroup.data(), &QActionGroup::triggered, this, &PlatformAgnosticActionGroup::triggered);
+    PLATFORMAGNOSTIC_TRACE(ActionGroupRemoveAction, this, action);
+
+    assert(action);
 
-    m_actionGroup->setProperty("agnosticActionGroup", QVariant::fromValue(this));
+    if (action->m_group == this)
+        action->setActionGroup(nullptr);
 }
 
-void WidgetsActionGroup::addAction(PlatformAgnosticAction *action)
+void PlatformAgnosticActionGroup::addActions(const QList<PlatformAgnosticAction *> &actionList)
 {
-    assert(qobject_cast<WidgetsAction*>(action));
-    assert(m_actionGroup);
+    m_actions.reserve(m_actions.size() + actionList.size());
 
-    m_actionGroup.data()->addAction(static_cast<WidgetsAction*>(action)->m_action.data());
+    for (const auto action : actionList)
+        addAction(action);
 }
 
-void WidgetsActionGroup::removeAction(PlatformAgnosticAction *action)
+void PlatformAgnosticActionGroup::clear()
 {
-    assert(qobject_cast<WidgetsAction*>(action));
-    assert(m_actionGroup);
+    PLATFORMAGNOSTIC_TRACE(ActionGroupClear, this);
 
-    m_actionGroup.data()->removeAction(static_cast<WidgetsAction*>(action)->m_action.data());
-}
+    // Taking the list up front saves removing the actions one by one from it
+    const auto actionList = std::exchange(m_actions, {});
 
-QObject* WidgetsActionGroup::actionGroup() const
-{
-    return m_actionGroup.data();
+    for (const auto action : actionList)
+    {
+        action->m_group = nullptr;
+        action->setActionGroup(nullptr);
+    }
 }
 
-void WidgetsActionGroup::setActionGroup(QObject *actionGroup)
+void PlatformAgnosticActionGroup::setCheckedIndex(const qsizetype index)
 {
-    assert(actionGroup);
-    assert(qobject_cast<QActionGroup*>(actionGroup));
+    PLATFORMAGNOSTIC_TRACE(ActionGroupSetCheckedIndex, this, qint64(index));
+
+    if (index < 0)
+    {
+        if (const auto action = checkedAction())
+            action->setChecked(false);
+        return;
+    }
 
-    m_actionGroup = static_cast<QActionGroup*>(actionGroup);
+    assert(index < m_actions.size());
+    m_actions.at(index)->setChecked(true);
 }
 
-QObject* QuickControls2ActionGroup::actionGroup() const
+void PlatformAgnosticActionGroup::adoptActions(const QList<PlatformAgnosticAction *> &actionList)
 {
-    return m_actionGroup.data();
+    for (const auto action : actionList)
+    {
+        if (!action->m_group)
+        {
+            action->m_group = this;
+            actionAdded(action);
+        }
+    }
 }
 
-void QuickControls2ActionGroup::setActionGroup(QObject *actionGroup)
+void PlatformAgnosticActionGroup::actionAdded(PlatformAgnosticAction *action)
 {
-    assert(actionGroup);
-    assert(actionGroup->inherits("QQuickActionGroup"));
-
-    m_actionGroup = actionGroup;
+    m_actions.push_back(action);
 }
 
-QuickControls2ActionGroup::QuickControls2ActionGroup(QObject *quickParent, QObject *parent)
-    : PlatformAgnosticActionGroup{parent}
+void PlatformAgnosticActionGroup::actionRemoved(PlatformAgnosticAction *action)
 {
-    assert(quickParent);
-
-    const auto engine = qmlEngine(quickParent);
-    assert(engine);
-
-    m_actionGroupComponent = new QQmlComponent(engine, QUrl(QStringLiteral(QQUICKCONTROLS2_ACTION_GROUP_PATH)), this);
-
-    m_actionGroup = m_actionGroupComponent->create(qmlContext(quickParent));
-    assert(m_actionGroup);
-    assert(m_actionGroup->inherits("QQuickActionGroup"));
-
-    QQmlEngine::setObjectOwnership(m_actionGroup, QQmlEngine::CppOwnership);
-
-    connect(m_actionGroup, SIGNAL(_triggered(QObject*)), this, SIGNAL(triggered(QObject*)));
-
-    m_actionGroup->setParent(this);
-
-    m_actionGroup->setProperty("platformAgnosticActionGroup", QVariant::fromValue(this));
+    m_actions.removeOne(action);
 }
 
-QuickControls2ActionGroup::QuickControls2ActionGroup(QObject *parent)
-    : QuickControls2ActionGroup{parent, parent}
+PlatformAgnosticAccounting::Usage PlatformAgnosticActionGroup::usage() const
 {
-
+    PlatformAgnosticAccounting::Usage usage;
+    usage.bytes = sizeof(PlatformAgnosticActionGroup) + m_actions.capacity() * sizeof(PlatformAgnosticAction*);
+    return usage;
 }
 
-void QuickControls2ActionGroup::addAction(PlatformAgnosticAction *action)
+void PlatformAgnosticActionGroup::setEnabled(const bool enabled)
 {
-    assert(qobject_cast<QuickControls2Action*>(action));
-    assert(m_actionGroup);
+    PLATFORMAGNOSTIC_TRACE(ActionGroupSetEnabled, this, enabled);
 
-    QMetaObject::invokeMethod(m_actionGroup.data(),
-                              "_addAction",
-                              Q_ARG(QVariant,
-                                    QVariant::fromValue(static_cast<QuickControls2Action*>(action)->m_action.data())));
+    assert(actionGroup());
+    actionGroup()->setProperty("enabled", enabled);
 }
 
-void QuickControls2ActionGroup::removeAction(PlatformAgnosticAction *action)
+void PlatformAgnosticActionGroup::setExclusive(const bool exclusive)
 {
-    assert(qobject_cast<QuickControls2Action*>(action));
-    assert(m_actionGroup);
+    PLATFORMAGNOSTIC_TRACE(ActionGroupSetExclusive, this, exclusive);
 
-    QMetaObject::invokeMethod(m_actionGroup.data(),
-                              "_removeAction",
-                              Q_ARG(QVariant,
-                                    QVariant::fromValue(static_cast<QuickControls2Action*>(action)->m_action.data())));
+    assert(actionGroup());
+    actionGroup()->setProperty("exclusive", exclusive);
 }
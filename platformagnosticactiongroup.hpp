@@ -27,6 +27,10 @@
 
 #include <QObject>
 #include <QPointer>
+#include <QList>
+
+#include "platformagnosticaccounting.hpp"
+#include "platformagnosticarena.hpp"
 
 class PlatformAgnosticAction;
 
@@ -39,15 +43,32 @@ class PlatformAgnosticActionGroup : public QObject
 
 public:
     explicit PlatformAgnosticActionGroup(QObject * parent = nullptr);
-    virtual ~PlatformAgnosticActionGroup() = default;
+    virtual ~PlatformAgnosticActionGroup();
+
+    static void* operator new(std::size_t size) { return PlatformAgnosticArena::allocate(size); }
+    static void operator delete(void* pointer) { PlatformAgnosticArena::deallocate(pointer); }
 
     template<class ActionGroup>
     static PlatformAgnosticActionGroup* fromActionGroup(ActionGroup actionGroup);
 
     static PlatformAgnosticActionGroup* createActionGroup(QObject *parent = nullptr);
 
-    virtual void addAction(PlatformAgnosticAction *action) = 0;
-    virtual void removeAction(PlatformAgnosticAction *action) = 0;
+    virtual void addAction(PlatformAgnosticAction *action);
+    virtual void removeAction(PlatformAgnosticAction *action);
+
+    void addActions(const QList<PlatformAgnosticAction*>& actionList);
+    virtual void clear();
+
+    QList<PlatformAgnosticAction*> actions() const { return m_actions; }
+    qsizetype count() const { return m_actions.size(); }
+
+    // Cached by the implementations, does not search the actions
+    virtual PlatformAgnosticAction* checkedAction() const = 0;
+    // Checks the action at index in the order of addition, -1 unchecks the checked action
+    void setCheckedIndex(qsizetype index);
+
+    // What the action group holds, for PlatformAgnosticAccounting::snapshot()
+    virtual PlatformAgnosticAccounting::Usage usage() const;
 
 public slots:
     virtual void setEnabled(bool enabled);
@@ -60,51 +81,19 @@ protected:
     QObject* operator()() const { return actionGroup(); };
     virtual QObject *actionGroup() const = 0;
     virtual void setActionGroup(QObject* actionGroup) = 0;
-};
-
-class WidgetsActionGroup : public PlatformAgnosticActionGroup
-{
-    Q_OBJECT
-
-    friend class WidgetsAction;
-
-public:
-    explicit WidgetsActionGroup(QObject* parent = nullptr);
-    virtual ~WidgetsActionGroup() = default;
 
-    void addAction(PlatformAgnosticAction *action) override;
-    void removeAction(PlatformAgnosticAction *action) override;
-
-protected:
-    QObject* actionGroup() const override;
-    void setActionGroup(QObject* actionGroup) override;
+    // Records the membership of actions that are already in the native group
+    void adoptActions(const QList<PlatformAgnosticAction*>& actionList);
 
 private:
-    QPointer<class QActionGroup> m_actionGroup;
-};
+    // Called by PlatformAgnosticAction::joinActionGroup()
+    void actionAdded(PlatformAgnosticAction* action);
+    void actionRemoved(PlatformAgnosticAction* action);
 
-class QuickControls2ActionGroup : public PlatformAgnosticActionGroup
-{
-    Q_OBJECT
-
-    friend class QuickControls2Action;
+    // Actions in the order they joined the group
+    QList<PlatformAgnosticAction*> m_actions;
 
-public:
-    QuickControls2ActionGroup(QObject* quickParent, class QObject* parent = nullptr);
-
-    explicit QuickControls2ActionGroup(QObject* parent);
-    virtual ~QuickControls2ActionGroup() = default;
-
-    void addAction(PlatformAgnosticAction *action) override;
-    void removeAction(PlatformAgnosticAction *action) override;
-
-protected:
-    QObject* actionGroup() const override;
-    void setActionGroup(QObject* actionGroup) override;
-
-private:
-    QPointer<QObject> m_actionGroup;
-    QPointer<class QQmlComponent> m_actionGroupComponent;
+    PlatformAgnosticAccounting::Entry m_accountingEntry{this};
 };
 
 #endif // PLATFORMAGNOSTICACTIONGROUP_HPP
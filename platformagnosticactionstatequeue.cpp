@@ -0,0 +1,136 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "platformagnosticactionstatequeue.hpp"
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QHash>
+#include <QThread>
+
+#include <cassert>
+#include <utility>
+
+#include "platformagnosticaction.hpp"
+
+namespace
+{
+
+const QEvent::Type FlushEvent = static_cast<QEvent::Type>(QEvent::registerEventType());
+
+}
+
+PlatformAgnosticActionStateQueue::PlatformAgnosticActionStateQueue(QObject *parent)
+    : QObject{parent}
+{
+
+}
+
+PlatformAgnosticActionStateQueue::~PlatformAgnosticActionStateQueue()
+{
+    Update* update = m_head.exchange(nullptr, std::memory_order_acquire);
+    while (update)
+        delete std::exchange(update, update->next);
+}
+
+void PlatformAgnosticActionStateQueue::setText(PlatformAgnosticAction *action, const QString &text)
+{
+    assert(action);
+    push(new Update{action, Text, false, text, nullptr});
+}
+
+void PlatformAgnosticActionStateQueue::setChecked(PlatformAgnosticAction *action, const bool checked)
+{
+    assert(action);
+    push(new Update{action, Checked, checked, {}, nullptr});
+}
+
+void PlatformAgnosticActionStateQueue::setEnabled(PlatformAgnosticAction *action, const bool enabled)
+{
+    assert(action);
+    push(new Update{action, Enabled, enabled, {}, nullptr});
+}
+
+void PlatformAgnosticActionStateQueue::push(Update *update)
+{
+    Update* head = m_head.load(std::memory_order_relaxed);
+    do
+    {
+        update->next = head;
+    }
+    while (!m_head.compare_exchange_weak(head, update, std::memory_order_release, std::memory_order_relaxed));
+
+    // Only the update that finds the stack empty schedules the flush
+    if (!head)
+        QCoreApplication::postEvent(this, new QEvent(FlushEvent));
+}
+
+void PlatformAgnosticActionStateQueue::flush()
+{
+    assert(thread() == QThread::currentThread());
+
+    // Taking the whole stack at once, there is no ABA problem to deal with
+    Update* update = m_head.exchange(nullptr, std::memory_order_acquire);
+    if (!update)
+        return;
+
+    // The stack is newest first, so the first update of a property is the one to apply
+    QHash<PlatformAgnosticAction*, quint8> applied;
+
+    while (update)
+    {
+        if (const auto action = update->action.data())
+        {
+            quint8& properties = applied[action];
+            if (!(properties & update->property))
+            {
+                properties |= update->property;
+
+                switch (update->property)
+                {
+                case Text:
+                    action->setText(update->text);
+                    break;
+                case Checked:
+                    action->setChecked(update->value);
+                    break;
+                case Enabled:
+                    action->setEnabled(update->value);
+                    break;
+                }
+            }
+        }
+
+        delete std::exchange(update, update->next);
+    }
+}
+
+bool PlatformAgnosticActionStateQueue::event(QEvent *event)
+{
+    if (event->type() == FlushEvent)
+    {
+        flush();
+        return true;
+    }
+
+    return QObject::event(event);
+}
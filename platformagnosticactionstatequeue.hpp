@@ -0,0 +1,83 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef PLATFORMAGNOSTICACTIONSTATEQUEUE_HPP
+#define PLATFORMAGNOSTICACTIONSTATEQUEUE_HPP
+
+#include <QObject>
+#include <QPointer>
+#include <QString>
+
+#include <atomic>
+
+class PlatformAgnosticAction;
+
+// Lets any thread change the text, checked and enabled state of actions without
+// a queued call per change. Updates are pushed to a lock-free stack and applied in
+// one go on the thread of the queue, once per event loop iteration. Only the last
+// write to a property of an action is applied.
+//
+// The queue should live on the thread of the actions. The actions must not be
+// destroyed while a setter naming them is running on another thread, but they
+// may be destroyed while their updates are pending.
+class PlatformAgnosticActionStateQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PlatformAgnosticActionStateQueue(QObject* parent = nullptr);
+    ~PlatformAgnosticActionStateQueue();
+
+    // Thread-safe:
+    void setText(PlatformAgnosticAction* action, const QString& text);
+    void setChecked(PlatformAgnosticAction* action, bool checked);
+    void setEnabled(PlatformAgnosticAction* action, bool enabled);
+
+    // Applies the pending updates right away, called on the thread of the queue
+    void flush();
+
+protected:
+    bool event(QEvent* event) override;
+
+private:
+    enum Property : quint8
+    {
+        Text = 1 << 0,
+        Checked = 1 << 1,
+        Enabled = 1 << 2
+    };
+
+    struct Update
+    {
+        QPointer<PlatformAgnosticAction> action;
+        Property property;
+        bool value;
+        QString text;
+        Update* next;
+    };
+
+    void push(Update* update);
+
+    std::atomic<Update*> m_head{nullptr};
+};
+
+#endif // PLATFORMAGNOSTICACTIONSTATEQUEUE_HPP
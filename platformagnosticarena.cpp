@@ -0,0 +1,146 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "platformagnosticarena.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+#include "platformagnosticmenu.hpp"
+
+namespace
+{
+
+// Put in front of every wrapper, so that deallocate() knows where the memory comes
+// from. The wrappers are QObjects, which need no more than pointer alignment.
+struct Header
+{
+    PlatformAgnosticArena* arena;
+};
+
+constexpr std::size_t BlockSize = 16 * 1024;
+
+thread_local PlatformAgnosticArena* t_current = nullptr;
+
+std::size_t aligned(const std::size_t size)
+{
+    return (size + alignof(Header) - 1) & ~(alignof(Header) - 1);
+}
+
+}
+
+PlatformAgnosticArena::Scope::Scope(PlatformAgnosticMenu *menu)
+    : m_previous{t_current}
+{
+    assert(menu);
+
+    for (QObject* object = menu; object; object = object->parent())
+    {
+        const auto parentMenu = qobject_cast<PlatformAgnosticMenu*>(object);
+        if (parentMenu && parentMenu->m_arena)
+        {
+            t_current = parentMenu->m_arena;
+            return;
+        }
+    }
+
+    menu->m_arena = new PlatformAgnosticArena;
+    t_current = menu->m_arena;
+}
+
+PlatformAgnosticArena::Scope::~Scope()
+{
+    t_current = m_previous;
+}
+
+PlatformAgnosticArena::~PlatformAgnosticArena()
+{
+    while (m_blocks)
+    {
+        Block* const block = m_blocks;
+        m_blocks = block->next;
+        ::operator delete(block);
+    }
+}
+
+void* PlatformAgnosticArena::allocate(const std::size_t size)
+{
+    const std::size_t total = sizeof(Header) + aligned(size);
+
+    PlatformAgnosticArena* const arena = t_current;
+
+    void* const memory = arena ? arena->allocateFromBlock(total) : ::operator new(total);
+
+    const auto header = static_cast<Header*>(memory);
+    header->arena = arena;
+    return header + 1;
+}
+
+void PlatformAgnosticArena::deallocate(void *pointer) noexcept
+{
+    if (!pointer)
+        return;
+
+    const auto header = static_cast<Header*>(pointer) - 1;
+
+    if (header->arena)
+        header->arena->deref();
+    else
+        ::operator delete(header);
+}
+
+void PlatformAgnosticArena::release()
+{
+    deref();
+}
+
+void* PlatformAgnosticArena::allocateFromBlock(const std::size_t size)
+{
+    if (static_cast<std::size_t>(m_end - m_cursor) < size)
+    {
+        // A wrapper larger than a block gets a block of its own
+        const std::size_t blockSize = std::max(BlockSize, sizeof(Block) + size);
+
+        const auto block = static_cast<Block*>(::operator new(blockSize));
+        block->next = m_blocks;
+        m_blocks = block;
+
+        m_cursor = reinterpret_cast<char*>(block) + sizeof(Block);
+        m_end = reinterpret_cast<char*>(block) + blockSize;
+
+        ++m_blockCount;
+    }
+
+    void* const memory = m_cursor;
+    m_cursor += size;
+    m_allocatedBytes += static_cast<qsizetype>(size);
+
+    m_refs.fetch_add(1, std::memory_order_relaxed);
+    return memory;
+}
+
+void PlatformAgnosticArena::deref()
+{
+    if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        delete this;
+}
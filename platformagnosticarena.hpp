@@ -0,0 +1,95 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef PLATFORMAGNOSTICARENA_HPP
+#define PLATFORMAGNOSTICARENA_HPP
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <cstddef>
+
+class PlatformAgnosticMenu;
+
+// Allocates the wrappers of one menu tree (menus, actions, action groups and the
+// state of lazy actions) from a few large blocks. The memory of a destroyed wrapper
+// is not reused, the blocks are freed together once the root menu and every object
+// allocated from the arena are destroyed. The native objects are still allocated by Qt.
+//
+// Opt-in, through PlatformAgnosticArena::Scope:
+//
+//     PlatformAgnosticArena::Scope scope(rootMenu);
+//     ... create the actions and the submenus of rootMenu ...
+class PlatformAgnosticArena
+{
+public:
+    // The wrappers created on the current thread while the scope lives are allocated
+    // from the arena of the closest menu that has one, starting from menu. If none
+    // has, menu gets one. Scopes nest.
+    class Scope
+    {
+    public:
+        explicit Scope(PlatformAgnosticMenu* menu);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        PlatformAgnosticArena* m_previous;
+    };
+
+    // Used by the operator new and delete of the wrappers. Every allocation, inside a
+    // scope or not, is preceded by a pointer-sized header naming its arena (or none),
+    // so that deallocate() knows where to give the memory back.
+    static void* allocate(std::size_t size);
+    static void deallocate(void* pointer) noexcept;
+
+    // Called by the menu that owns the arena, when it is destroyed
+    void release();
+
+    qsizetype blockCount() const { return m_blockCount; }
+    qsizetype allocatedBytes() const { return m_allocatedBytes; }
+
+private:
+    PlatformAgnosticArena() = default;
+    ~PlatformAgnosticArena();
+
+    struct Block
+    {
+        Block* next;
+    };
+
+    void* allocateFromBlock(std::size_t size);
+    void deref();
+
+    Block* m_blocks = nullptr;
+    char* m_cursor = nullptr;
+    char* m_end = nullptr;
+    qsizetype m_blockCount = 0;
+    qsizetype m_allocatedBytes = 0;
+
+    // The owner and the live objects, which may be destroyed on other threads
+    std::atomic<qsizetype> m_refs{1};
+};
+
+#endif // PLATFORMAGNOSTICARENA_HPP
@@ -0,0 +1,116 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "platformagnosticbackend.hpp"
+
+#include <QDebug>
+
+#include <array>
+#include <cassert>
+#include <utility>
+
+#include "platformagnosticaction.hpp"
+#include "platformagnosticactiongroup.hpp"
+#include "platformagnosticnull.hpp"
+#include "platformagnostictrace.hpp"
+
+namespace
+{
+
+using Factories = std::array<PlatformAgnosticBackend::Factory, 3>;
+
+Factories& factories()
+{
+    // Indexed by PlatformAgnosticMenu::Backend. Function local, because
+    // the backends register themselves during static initialization.
+    static Factories s_factories = {
+        PlatformAgnosticBackend::Factory{},
+        PlatformAgnosticBackend::Factory{},
+        PlatformAgnosticBackend::Factory{&NullMenu::create, &NullAction::create, &NullActionGroup::create}
+    };
+    return s_factories;
+}
+
+template<auto Create, typename... Args>
+auto create(QObject* parent, const Args... args) -> decltype((std::declval<PlatformAgnosticBackend::Factory>().*Create)(parent, args...))
+{
+    if (!parent)
+    {
+        const auto backend = PlatformAgnosticMenu::defaultBackend();
+        const auto& factory = factories()[static_cast<size_t>(backend)];
+        if (factory.*Create)
+            return (factory.*Create)(nullptr, args...);
+
+        qWarning("PlatformAgnosticMenus: the default backend %d is not linked in", static_cast<int>(backend));
+        return nullptr;
+    }
+
+    for (const auto& factory : factories())
+    {
+        if (!(factory.*Create))
+            continue;
+
+        if (const auto object = (factory.*Create)(parent, args...))
+            return object;
+    }
+
+    qWarning("PlatformAgnosticMenus: no registered backend accepts a parent of type %s", parent->metaObject()->className());
+    return nullptr;
+}
+
+}
+
+bool PlatformAgnosticBackend::registerFactory(const Backend backend, const Factory &factory)
+{
+    assert(factory.createMenu && factory.createAction && factory.createActionGroup);
+    factories()[static_cast<size_t>(backend)] = factory;
+    return true;
+}
+
+bool PlatformAgnosticBackend::isRegistered(const Backend backend)
+{
+    return factories()[static_cast<size_t>(backend)].createMenu;
+}
+
+PlatformAgnosticMenu* PlatformAgnosticBackend::createMenu(QObject *parent)
+{
+    PlatformAgnosticTrace::Scope trace{PlatformAgnosticTrace::Op::CreateMenu, nullptr, parent};
+    const auto menu = create<&Factory::createMenu>(parent);
+    trace.setResult(menu);
+    return menu;
+}
+
+PlatformAgnosticAction* PlatformAgnosticBackend::createAction(QObject *parent, const bool lazy)
+{
+    PlatformAgnosticTrace::Scope trace{PlatformAgnosticTrace::Op::CreateAction, nullptr, parent, lazy};
+    const auto action = create<&Factory::createAction>(parent, lazy);
+    trace.setResult(action);
+    return action;
+}
+
+PlatformAgnosticActionGroup* PlatformAgnosticBackend::createActionGroup(QObject *parent)
+{
+    PlatformAgnosticTrace::Scope trace{PlatformAgnosticTrace::Op::CreateActionGroup, nullptr, parent};
+    const auto actionGroup = create<&Factory::createActionGroup>(parent);
+    trace.setResult(actionGroup);
+    return actionGroup;
+}
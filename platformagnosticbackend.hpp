@@ -0,0 +1,59 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef PLATFORMAGNOSTICBACKEND_HPP
+#define PLATFORMAGNOSTICBACKEND_HPP
+
+#include "platformagnosticmenu.hpp"
+
+class QObject;
+class PlatformAgnosticAction;
+class PlatformAgnosticActionGroup;
+
+// Lets createMenu(), createAction() and createActionGroup() create the objects of
+// the backends that are linked in, so that the core does not depend on Qt Widgets
+// or Qt Quick. The null backend is part of the core and is always registered.
+namespace PlatformAgnosticBackend
+{
+    using Backend = PlatformAgnosticMenu::Backend;
+
+    // The functions return nullptr for a parent of another backend,
+    // and a top level object for a null parent if the backend supports it
+    struct Factory
+    {
+        PlatformAgnosticMenu* (*createMenu)(QObject* parent) = nullptr;
+        PlatformAgnosticAction* (*createAction)(QObject* parent, bool lazy) = nullptr;
+        PlatformAgnosticActionGroup* (*createActionGroup)(QObject* parent) = nullptr;
+    };
+
+    // Returns true, so that it can initialize a static variable
+    bool registerFactory(Backend backend, const Factory& factory);
+    bool isRegistered(Backend backend);
+
+    // A null parent goes to the default backend, other parents are offered to the
+    // registered backends in turn. Returns nullptr with a warning if no backend takes it.
+    PlatformAgnosticMenu* createMenu(QObject* parent);
+    PlatformAgnosticAction* createAction(QObject* parent, bool lazy);
+    PlatformAgnosticActionGroup* createActionGroup(QObject* parent);
+}
+
+#endif // PLATFORMAGNOSTICBACKEND_HPP
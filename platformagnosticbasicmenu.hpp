@@ -0,0 +1,155 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef PLATFORMAGNOSTICBASICMENU_HPP
+#define PLATFORMAGNOSTICBASICMENU_HPP
+
+#include <QString>
+
+#include <cassert>
+
+#include "platformagnosticnull.hpp"
+#ifdef PLATFORMAGNOSTICMENUS_WIDGETS
+#include "platformagnosticwidgets.hpp"
+#endif
+#ifdef PLATFORMAGNOSTICMENUS_QUICKCONTROLS2
+#include "platformagnosticquickcontrols2.hpp"
+#endif
+
+// Backends for BasicMenu. The backend classes are final, so the calls made through
+// their pointers are not dispatched through the virtual table.
+
+#ifdef PLATFORMAGNOSTICMENUS_WIDGETS
+struct WidgetsBackend
+{
+    using Menu = WidgetsMenu;
+    using Action = WidgetsAction;
+    using ActionGroup = WidgetsActionGroup;
+
+    static Action* createAction(Menu* parent, bool lazy) { return new Action(parent, lazy); }
+    static ActionGroup* createActionGroup(Menu* parent) { return new ActionGroup(parent); }
+};
+#endif
+
+#ifdef PLATFORMAGNOSTICMENUS_QUICKCONTROLS2
+struct QuickControls2Backend
+{
+    using Menu = QuickControls2Menu;
+    using Action = QuickControls2Action;
+    using ActionGroup = QuickControls2ActionGroup;
+
+    static Action* createAction(Menu* parent, bool lazy) { return new Action((*parent)(), parent, lazy); }
+    static ActionGroup* createActionGroup(Menu* parent) { return new ActionGroup((*parent)(), parent); }
+};
+#endif
+
+struct NullBackend
+{
+    using Menu = NullMenu;
+    using Action = NullAction;
+    using ActionGroup = NullActionGroup;
+
+    static Action* createAction(Menu* parent, bool lazy) { return new Action(parent, lazy); }
+    static ActionGroup* createActionGroup(Menu* parent) { return new ActionGroup(parent); }
+};
+
+// Statically typed handle for builds that use a single backend.
+// It does not own the menu, and converts to PlatformAgnosticMenu* so
+// it can be mixed with the polymorphic API.
+template<class Backend>
+class BasicMenu
+{
+public:
+    using Menu = typename Backend::Menu;
+    using Action = typename Backend::Action;
+    using ActionGroup = typename Backend::ActionGroup;
+
+    BasicMenu() = default;
+    explicit BasicMenu(Menu* menu) : m_menu{menu} { }
+
+    // Unlike PlatformAgnosticMenu::createMenu(), the parent is not inspected
+    template<class Parent>
+    static BasicMenu create(Parent parent) { return BasicMenu{new Menu(parent)}; }
+
+    static BasicMenu fromMenu(PlatformAgnosticMenu* menu)
+    {
+        assert(qobject_cast<Menu*>(menu));
+        return BasicMenu{static_cast<Menu*>(menu)};
+    }
+
+    Menu* get() const { return m_menu; }
+    Menu* operator->() const { return m_menu; }
+    operator Menu*() const { return m_menu; }
+
+    BasicMenu addMenu(const QString& title)
+    {
+        assert(m_menu);
+        const auto menu = new Menu(m_menu);
+        menu->setTitle(title);
+        m_menu->addMenu(menu);
+        return BasicMenu{menu};
+    }
+
+    Action* createAction(bool lazy = false) const
+    {
+        assert(m_menu);
+        return Backend::createAction(m_menu, lazy);
+    }
+
+    ActionGroup* createActionGroup() const
+    {
+        assert(m_menu);
+        return Backend::createActionGroup(m_menu);
+    }
+
+    Action* addAction(const QString& text)
+    {
+        const auto action = createAction();
+        action->setText(text);
+        m_menu->addAction(action);
+        return action;
+    }
+
+    Action* addAction(const QString& iconSource, const QString& text)
+    {
+        const auto action = addAction(text);
+        action->setIcon(iconSource);
+        return action;
+    }
+
+    void addAction(Action* action) { m_menu->addAction(action); }
+    void insertAction(Action* before, Action* action) { m_menu->insertAction(before, action); }
+    void removeAction(Action* action) { m_menu->removeAction(action); }
+
+private:
+    Menu* m_menu = nullptr;
+};
+
+#ifdef PLATFORMAGNOSTICMENUS_WIDGETS
+using BasicWidgetsMenu = BasicMenu<WidgetsBackend>;
+#endif
+#ifdef PLATFORMAGNOSTICMENUS_QUICKCONTROLS2
+using BasicQuickControls2Menu = BasicMenu<QuickControls2Backend>;
+#endif
+using BasicNullMenu = BasicMenu<NullBackend>;
+
+#endif // PLATFORMAGNOSTICBASICMENU_HPP
@@ -0,0 +1,95 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "platformagnosticeventhook.hpp"
+
+#include <cassert>
+
+PlatformAgnosticEventHook::PlatformAgnosticEventHook(QObject *parent)
+    : QObject{parent}
+{
+
+}
+
+void PlatformAgnosticEventHook::setTargets(const QList<QObject *> &targets)
+{
+    for (const auto& target : std::as_const(m_targets))
+    {
+        if (target)
+            target->removeEventFilter(this);
+    }
+
+    m_targets.clear();
+
+    for (const auto target : targets)
+    {
+        assert(target);
+        target->installEventFilter(this);
+        m_targets.push_back(target);
+    }
+}
+
+int PlatformAgnosticEventHook::addHandler(const QEvent::Type type, Handler handler)
+{
+    assert(handler);
+
+    const int id = m_nextId++;
+    m_handlers[type].push_back({id, std::move(handler)});
+    m_types.insert(id, type);
+    return id;
+}
+
+bool PlatformAgnosticEventHook::removeHandler(const int id)
+{
+    const auto typeIt = m_types.constFind(id);
+    if (typeIt == m_types.cend())
+        return false;
+
+    const auto it = m_handlers.find(*typeIt);
+    assert(it != m_handlers.end());
+
+    it->removeIf([id](const Entry& entry) { return entry.id == id; });
+    if (it->isEmpty())
+        m_handlers.erase(it);
+
+    m_types.erase(typeIt);
+    return true;
+}
+
+bool PlatformAgnosticEventHook::eventFilter(QObject *watched, QEvent *event)
+{
+    Q_UNUSED(watched);
+
+    const auto it = m_handlers.constFind(event->type());
+    if (it == m_handlers.cend())
+        return false;
+
+    // Sharing the list keeps the handlers alive if they are removed while dispatching
+    const auto entries = *it;
+    for (const auto& entry : entries)
+    {
+        if (entry.handler(event))
+            return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,70 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef PLATFORMAGNOSTICEVENTHOOK_HPP
+#define PLATFORMAGNOSTICEVENTHOOK_HPP
+
+#include <QObject>
+#include <QEvent>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+
+#include <functional>
+
+// A single event filter for a set of native objects, which dispatches
+// each event only to the handlers registered for its type
+class PlatformAgnosticEventHook : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Returning true filters the event out
+    using Handler = std::function<bool(QEvent*)>;
+
+    explicit PlatformAgnosticEventHook(QObject* parent = nullptr);
+
+    void setTargets(const QList<QObject*>& targets);
+
+    // Returns an id to remove the handler with
+    int addHandler(QEvent::Type type, Handler handler);
+    bool removeHandler(int id);
+
+    bool isEmpty() const { return m_handlers.isEmpty(); }
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+    struct Entry
+    {
+        int id;
+        Handler handler;
+    };
+
+    QHash<int, QList<Entry>> m_handlers;
+    QHash<int, QEvent::Type> m_types;
+    QList<QPointer<QObject>> m_targets;
+    int m_nextId = 1;
+};
+
+#endif // PLATFORMAGNOSTICEVENTHOOK_HPP
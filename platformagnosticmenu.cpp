@@ -22,52 +22,95 @@
  */
 #include "platformagnosticmenu.hpp"
 
-#include <QMenu>
-#include <QQmlComponent>
-#include <QQmlEngine>
-#include <QQuickWindow>
-#include <QQuickItem>
-#include <QQmlListReference>
-#include <QWidgetAction>
-#include <QQmlInfo>
+#include <QTimer>
 
-#define QQUICKCONTROLS2_MENU_PATH "qrc:///widgets/MenuExt.qml"
-#define QQUICKCONTROLS2_MENU_SEPARATOR_PATH "qrc:///widgets/MenuSeparatorExt.qml"
+#include <algorithm>
+#include <iterator>
+#include <utility>
 
+#include "platformagnosticbackend.hpp"
+#include "platformagnosticspeculativebuilder.hpp"
+#include "platformagnostictrace.hpp"
+
+namespace
+{
+
+PlatformAgnosticMenu::Backend s_defaultBackend = PlatformAgnosticMenu::Backend::Widgets;
+
+}
 
 PlatformAgnosticMenu::PlatformAgnosticMenu(QObject * parent)
     : QObject{parent}
 {
+    // Connected first, so that the content is provided and the lazy actions are
+    // materialized before any other slot connected to aboutToShow() is called
+    connect(this, &PlatformAgnosticMenu::aboutToShow, this, &PlatformAgnosticMenu::onAboutToShow);
+}
+
+PlatformAgnosticMenu::~PlatformAgnosticMenu()
+{
+    PLATFORMAGNOSTIC_TRACE(Destroy, this);
 
+    for (const auto action : std::as_const(m_actions))
+        action->m_menus.removeOne(this);
+
+    // The children allocated from the arena keep it alive until they are destroyed
+    if (m_arena)
+        m_arena->release();
 }
 
 void PlatformAgnosticMenu::installEventFilter(QObject *object)
 {
-    assert(menu());
-    menu()->installEventFilter(object);
+    const auto targets = eventTargets();
+    for (const auto target : targets)
+        target->installEventFilter(object);
 }
 
 void PlatformAgnosticMenu::removeEventFilter(QObject *object)
 {
-    assert(menu());
-    menu()->installEventFilter(object);
+    const auto targets = eventTargets();
+    for (const auto target : targets)
+        target->removeEventFilter(object);
 }
 
-template<>
-PlatformAgnosticMenu* PlatformAgnosticMenu::fromMenu(QMenu * menu)
+int PlatformAgnosticMenu::addEventHandler(const QEvent::Type type, PlatformAgnosticEventHook::Handler handler)
 {
-    assert(menu);
+    if (!m_eventHook)
+    {
+        m_eventHook = new PlatformAgnosticEventHook(this);
+        m_eventHook->setTargets(eventTargets());
+    }
 
-    PlatformAgnosticMenu* const widgetsMenu = new WidgetsMenu;
+    return m_eventHook->addHandler(type, std::move(handler));
+}
 
-    widgetsMenu->setMenu(menu);
+void PlatformAgnosticMenu::removeEventHandler(const int id)
+{
+    if (!m_eventHook)
+        return;
 
-    connect(menu, &QMenu::aboutToHide, widgetsMenu, &PlatformAgnosticMenu::aboutToHide);
-    connect(menu, &QMenu::aboutToShow, widgetsMenu, &PlatformAgnosticMenu::aboutToShow);
+    m_eventHook->removeHandler(id);
 
-    menu->setProperty("platformAgnosticMenu", QVariant::fromValue(widgetsMenu));
+    // Do not keep filtering the events of the menu for nothing. The hook may be
+    // dispatching right now, if a handler removes itself.
+    if (m_eventHook->isEmpty())
+    {
+        m_eventHook->setTargets({});
+        m_eventHook->deleteLater();
+        m_eventHook = nullptr;
+    }
+}
 
-    return widgetsMenu;
+QList<QObject *> PlatformAgnosticMenu::eventTargets() const
+{
+    assert(menu());
+    return {menu()};
+}
+
+void PlatformAgnosticMenu::updateEventTargets()
+{
+    if (m_eventHook)
+        m_eventHook->setTargets(eventTargets());
 }
 
 template<>
@@ -79,23 +122,19 @@ PlatformAgnosticMenu* PlatformAgnosticMenu::fromMenu(PlatformAgnosticMenu * Plat
 
 PlatformAgnosticMenu* PlatformAgnosticMenu::createMenu(QObject* parent)
 {
-    if (!parent)
-    {
-        return new WidgetsMenu;
-    }
-    else
-    {
-        if (const auto widgetsMenuParent = qobject_cast<WidgetsMenu*>(parent))
-            return new WidgetsMenu(widgetsMenuParent);
-        else if (const auto quickControls2MenuParent = qobject_cast<QuickControls2Menu*>(parent))
-            return new QuickControls2Menu(quickControls2MenuParent);
-        else if (const auto quickWindowParent = qobject_cast<QQuickWindow*>(parent))
-            return new QuickControls2Menu(quickWindowParent);
-        else if (const auto quickItemParent = qobject_cast<QQuickItem*>(parent))
-            return new QuickControls2Menu(quickItemParent);
-        else
-            Q_UNREACHABLE();
-    }
+    return PlatformAgnosticBackend::createMenu(parent);
+}
+
+void PlatformAgnosticMenu::setDefaultBackend(const Backend backend)
+{
+    assert(backend != Backend::QuickControls2);
+    assert(PlatformAgnosticBackend::isRegistered(backend));
+    s_defaultBackend = backend;
+}
+
+PlatformAgnosticMenu::Backend PlatformAgnosticMenu::defaultBackend()
+{
+    return s_defaultBackend;
 }
 
 PlatformAgnosticMenu* PlatformAgnosticMenu::createMenu(const QString& text, QObject *parent)
@@ -113,472 +152,649 @@ PlatformAgnosticMenu* PlatformAgnosticMenu::addMenu(const QString &title)
     return menu;
 }
 
-void PlatformAgnosticMenu::clear()
+void PlatformAgnosticMenu::batchUpdates(const std::function<void ()> &updates)
 {
-    const auto actionList = actions();
-
-    for (const auto action : actionList)
-    {
-        removeAction(action);
-        if (action->parent() == this)
-            delete action;
-    }
+    // QQuickMenu lays out its content once per frame anyway
+    updates();
 }
 
-bool PlatformAgnosticMenu::isEmpty() const
+void PlatformAgnosticMenu::setContentProvider(ContentProvider provider)
 {
-    bool empty = true;
-    const auto actionList = actions();
-    for (const auto action : actionList)
-    {
-        if (action->isVisible())
-            empty = false;
-    }
-    return empty;
+    m_contentProvider = std::move(provider);
 }
 
-void PlatformAgnosticMenu::setTitle(const QString &title)
+void PlatformAgnosticMenu::invalidateContent()
 {
-    assert(menu());
+    if (!m_contentBuilt)
+        return;
 
-    // Both QQuickMenu and QMenu has the 'title' property
-    // Which makes this method very convenient to implement
-    menu()->setProperty("title", title);
-}
+    clear();
+    m_contentBuilt = false;
 
-void PlatformAgnosticMenu::setEnabled(const bool enabled)
-{
-    assert(menu());
-    menu()->setProperty("enabled", enabled);
+    // A menu that is shown is filled again right away
+    if (menu() && isNativeVisible())
+        buildContent();
 }
 
-PlatformAgnosticAction* PlatformAgnosticMenu::addAction(const QString& iconSource, const QString& text)
+bool PlatformAgnosticMenu::needsBuild() const
 {
-    const auto action = addAction(text);
-    action->setIcon(iconSource);
-    return action;
+    return (m_contentProvider && !m_contentBuilt) || !m_pendingEntries.isEmpty();
 }
 
-PlatformAgnosticAction* PlatformAgnosticMenu::addAction(const QString& text)
+bool PlatformAgnosticMenu::buildContent(const QDeadlineTimer deadline)
 {
-    const auto action = PlatformAgnosticAction::createAction(this);
-    action->setText(text);
-    addAction(action);
-    return action;
-}
+    if (m_contentProvider && !m_contentBuilt)
+    {
+        m_contentBuilt = true;
+        m_contentProvider(this);
 
-WidgetsMenu::WidgetsMenu(WidgetsMenu* parent)
-    : PlatformAgnosticMenu{parent}
-{
-    m_menu = new QMenu(parent ? parent->m_menu : nullptr);
-    connect(m_menu.data(), &QMenu::aboutToHide, this, &PlatformAgnosticMenu::aboutToHide);
-    connect(m_menu.data(), &QMenu::aboutToShow, this, &PlatformAgnosticMenu::aboutToShow);
+        if (deadline.hasExpired())
+            return false;
+    }
 
-    //static_cast<QObject*>(m_menu)->setParent(this); // Qt bug
+    if (!materializePendingEntries(deadline))
+        return false;
 
-    m_menu->setProperty("platformAgnosticMenu", QVariant::fromValue(this));
+    // QMenu and QQuickMenu keep the layout until the content changes
+    sizeHint();
+    return true;
 }
 
-WidgetsMenu::~WidgetsMenu()
+void PlatformAgnosticMenu::onAboutToShow()
 {
-    // Since we can not set QObject::parent on m_menu
-    // we should delete it here
-    assert(m_menu);
-    m_menu->deleteLater();
-}
+    if (m_contentProvider && !m_contentBuilt)
+    {
+        m_contentBuilt = true;
+        m_contentProvider(this);
+    }
 
-void WidgetsMenu::insertAction(PlatformAgnosticAction *before, PlatformAgnosticAction *action)
-{
-    assert(m_menu);
-    assert(qobject_cast<WidgetsAction*>(action));
+    pullActionStates(m_actions);
+    materializePendingActions();
+    PlatformAgnosticSpeculativeBuilder::cancel(this);
 
-    if (before)
+    // The submenus are likely to be shown next
+    const auto submenus = findChildren<PlatformAgnosticMenu*>(Qt::FindDirectChildrenOnly);
+    for (const auto submenu : submenus)
     {
-        assert(qobject_cast<WidgetsAction*>(before));
-        m_menu->insertAction(static_cast<WidgetsAction*>(before)->m_action, static_cast<WidgetsAction*>(action)->m_action);
+        if (submenu->needsBuild())
+            PlatformAgnosticSpeculativeBuilder::schedule(submenu);
     }
-    else
+}
+
+void PlatformAgnosticMenu::pullActionStates(const QList<PlatformAgnosticAction *> &actionList)
+{
+    QList<PlatformAgnosticAction*> changed;
+
+    for (const auto action : actionList)
     {
-        addAction(action);
+        // The hidden actions are evaluated once they are shown
+        if (!action->m_stateProviders || !action->isVisible() || action->m_filteredOut)
+            continue;
+
+        if (action->evaluateStateProviders())
+            changed.push_back(action);
     }
+
+    if (changed.isEmpty())
+        return;
+
+    batchUpdates([&changed]() {
+        for (const auto action : std::as_const(changed))
+            action->applyProvidedState();
+    });
 }
 
-void WidgetsMenu::clear()
+void PlatformAgnosticMenu::pullShownActionStates(const QList<PlatformAgnosticAction *> &actionList)
 {
-    assert(m_menu);
-    m_menu->clear();
+    // Otherwise they are pulled on the next show
+    if (!actionList.isEmpty() && menu() && isNativeVisible())
+        pullActionStates(actionList);
 }
 
-void WidgetsMenu::addAction(PlatformAgnosticAction *action)
+void PlatformAgnosticMenu::submenuHovered(PlatformAgnosticMenu *submenu)
 {
-    assert(qobject_cast<WidgetsAction*>(action));
-    assert(m_menu);
+    assert(submenu);
 
-    m_menu->addAction(static_cast<WidgetsAction*>(action)->m_action);
+    if (submenu->needsBuild())
+        PlatformAgnosticSpeculativeBuilder::schedule(submenu, true);
 }
 
-void WidgetsMenu::removeAction(PlatformAgnosticAction *action)
+void PlatformAgnosticMenu::setPageSize(const int size)
 {
-    assert(qobject_cast<WidgetsAction*>(action));
-    assert(m_menu);
-
-    m_menu->removeAction(static_cast<WidgetsAction*>(action)->m_action);
+    assert(size >= 0);
+    m_pageSize = size;
 }
 
-void WidgetsMenu::addMenu(PlatformAgnosticMenu *menu)
+void PlatformAgnosticMenu::setHibernationDelay(const int msec)
 {
-    assert(qobject_cast<WidgetsMenu*>(menu));
-    assert(m_menu);
+    m_hibernationDelay = msec;
+
+    if (msec < 0)
+    {
+        delete m_hibernationTimer;
+        m_hibernationTimer = nullptr;
+        return;
+    }
+
+    if (!m_hibernationTimer)
+    {
+        m_hibernationTimer = new QTimer(this);
+        m_hibernationTimer->setSingleShot(true);
 
-    m_menu->addMenu(static_cast<WidgetsMenu*>(menu)->m_menu);
+        connect(m_hibernationTimer, &QTimer::timeout, this, &PlatformAgnosticMenu::onHibernationTimeout);
+        connect(this, &PlatformAgnosticMenu::aboutToHide, m_hibernationTimer, qOverload<>(&QTimer::start));
+        connect(this, &PlatformAgnosticMenu::aboutToShow, m_hibernationTimer, &QTimer::stop);
+    }
+
+    m_hibernationTimer->setInterval(msec);
 }
 
-void WidgetsMenu::popup(const QPoint &pos)
+void PlatformAgnosticMenu::onHibernationTimeout()
 {
-    assert(m_menu);
-    m_menu->popup(pos);
+    assert(menu());
+
+    // The exit transition of a QQuickMenu may still be running
+    if (isNativeVisible())
+        m_hibernationTimer->start();
+    else
+        hibernate();
 }
 
-QList<PlatformAgnosticAction *> WidgetsMenu::actions() const
+qint64 PlatformAgnosticMenu::hibernate()
 {
-    assert(m_menu);
+    assert(menu());
 
-    QList<PlatformAgnosticAction *> list;
+    if (m_hibernated || isNativeVisible())
+        return 0;
 
-    const auto actions = static_cast<QMenu*>(m_menu.data())->actions();
+    const qint64 before = PlatformAgnosticAccounting::heapBytes();
 
-    for (const auto i : actions)
+    auto entries = takeNativeContent();
+
+    for (const auto& entry : std::as_const(entries))
     {
-        if (const auto PlatformagnosticAction = i->property("platformAgnosticAction").value<PlatformAgnosticAction*>())
-            list.push_back(PlatformagnosticAction);
+        // The actions that can not be dematerialized are added back as they are
+        if (entry.action)
+            entry.action->dematerialize();
     }
 
-    return list;
+    // The native content came before the pending entries
+    entries.append(std::exchange(m_pendingEntries, {}));
+    m_pendingEntries = std::move(entries);
+    m_hibernated = !m_pendingEntries.isEmpty();
+
+    const qint64 reclaimed = (before < 0) ? -1 : before - PlatformAgnosticAccounting::heapBytes();
+    emit hibernated(reclaimed);
+    return reclaimed;
+}
+
+PlatformAgnosticAccounting::Usage PlatformAgnosticMenu::usage() const
+{
+    PlatformAgnosticAccounting::Usage usage;
+    usage.bytes = sizeof(PlatformAgnosticMenu)
+                  + m_actions.capacity() * sizeof(PlatformAgnosticAction*)
+                  + m_pendingEntries.capacity() * sizeof(PendingEntry)
+                  + m_filterMatches.capacity() * sizeof(PlatformAgnosticAction*);
+    return usage;
 }
 
-void WidgetsMenu::close()
+void PlatformAgnosticMenu::clear()
 {
-    assert(m_menu);
+    const auto actionList = actions();
 
-    m_menu->close();
+    for (const auto action : actionList)
+    {
+        removeAction(action);
+        if (action->parent() == this)
+            delete action;
+    }
+
+    // Drops the pending separators
+    clearPendingActions();
 }
 
-void WidgetsMenu::addSeparator()
+bool PlatformAgnosticMenu::containsAction(PlatformAgnosticAction *action) const
 {
-    assert(m_menu);
-    m_menu->addSeparator();
+    assert(action);
+    return action->m_menus.contains(const_cast<PlatformAgnosticMenu*>(this));
 }
 
-QSize WidgetsMenu::sizeHint() const
+bool PlatformAgnosticMenu::isEmpty() const
 {
-    assert(m_menu);
-    return m_menu->sizeHint();
+    return (m_visibleCount == 0);
 }
 
-void WidgetsMenu::setTearOffEnabled(bool enabled)
+QList<PlatformAgnosticAction *> PlatformAgnosticMenu::actions() const
 {
-    assert(m_menu);
-    m_menu->setTearOffEnabled(enabled);
+    return m_actions;
 }
 
-void WidgetsMenu::addItem(QObject *item)
+void PlatformAgnosticMenu::setTitle(const QString &title)
 {
-    assert(m_menu);
-    assert(qobject_cast<QWidgetAction*>(item));
+    PLATFORMAGNOSTIC_TRACE(MenuSetTitle, this, title);
+
+    assert(menu());
+
+    // Both QQuickMenu and QMenu has the 'title' property
+    // Which makes this method very convenient to implement
+    menu()->setProperty("title", title);
+}
 
-    m_menu->addAction(static_cast<QWidgetAction*>(item));
+bool PlatformAgnosticMenu::isNativeVisible() const
+{
+    assert(menu());
+    return menu()->property("visible").toBool();
 }
 
-void WidgetsMenu::removeItem(QObject *item)
+void PlatformAgnosticMenu::setEnabled(const bool enabled)
 {
-    assert(m_menu);
-    assert(qobject_cast<QWidgetAction*>(item));
+    PLATFORMAGNOSTIC_TRACE(MenuSetEnabled, this, enabled);
 
-    m_menu->removeAction(static_cast<QWidgetAction*>(item));
+    assert(menu());
+    menu()->setProperty("enabled", enabled);
 }
 
-QObject* WidgetsMenu::menu() const
+PlatformAgnosticAction* PlatformAgnosticMenu::addAction(const QString& iconSource, const QString& text)
 {
-    return m_menu.data();
+    const auto action = addAction(text);
+    action->setIcon(iconSource);
+    return action;
 }
 
-void WidgetsMenu::setMenu(QObject *menu)
+PlatformAgnosticAction* PlatformAgnosticMenu::addAction(const QString& text)
 {
-    assert(menu);
-    assert(qobject_cast<QMenu*>(menu));
-    m_menu = static_cast<QMenu*>(menu);
+    const auto action = PlatformAgnosticAction::createAction(this);
+    action->setText(text);
+    addAction(action);
+    return action;
 }
 
-QuickControls2Menu::QuickControls2Menu(QObject *quickParent, QObject* parent)
-    : PlatformAgnosticMenu{parent}
+bool PlatformAgnosticMenu::deferAction(PlatformAgnosticAction *action)
 {
-    assert(quickParent);
-
-    // In normal cases, quickParent should have a valid qml engine associated to its context:
-    QQmlEngine* engine = qmlEngine(quickParent);
+    assert(action);
 
-    if (!engine)
+    if (action->isLazy())
     {
-        // Sometimes QQuickRootItem does not have an engine associated to its context
-        // In these cases, the engine is probed using its first QQuickItem child.
-        if (const auto itemParent = qobject_cast<QQuickItem*>(quickParent))
-        {
-            const auto children = QQmlListReference(quickParent, "children");
-            if (children.count() > 0)
-                engine = qmlEngine(children.at(0));
-        }
+        m_pendingEntries.push_back({action, false, {}});
+        return true;
     }
+    else
+    {
+        // Keep the order
+        materializePendingActions();
+        return false;
+    }
+}
 
-    assert(engine);
-
-    m_menuComponent = new QQmlComponent(engine, QUrl(QStringLiteral(QQUICKCONTROLS2_MENU_PATH)), this);
-    m_menuSeparatorComponent = new QQmlComponent(
-        engine,
-        QUrl(QStringLiteral(QQUICKCONTROLS2_MENU_SEPARATOR_PATH)),
-        this);
-    m_menu = m_menuComponent->create(qmlContext(quickParent));
-    assert(m_menu);
-    assert(m_menu->inherits("QQuickMenu"));
+bool PlatformAgnosticMenu::removePendingAction(PlatformAgnosticAction *action)
+{
+    const auto it = std::find_if(m_pendingEntries.begin(), m_pendingEntries.end(), [action](const PendingEntry& entry) {
+        return !entry.isSeparator && entry.action == action;
+    });
 
-    QQmlEngine::setObjectOwnership(m_menu, QQmlEngine::CppOwnership);
+    if (it == m_pendingEntries.end())
+        return false;
 
-    m_menu->setParent(this);
+    m_pendingEntries.erase(it);
+    return true;
+}
 
-    connect(m_menu, SIGNAL(aboutToShow()), this, SIGNAL(aboutToShow()));
-    connect(m_menu, SIGNAL(aboutToHide()), this, SIGNAL(aboutToHide()));
+bool PlatformAgnosticMenu::removePendingItem(QObject *item)
+{
+    const auto it = std::find_if(m_pendingEntries.begin(), m_pendingEntries.end(), [item](const PendingEntry& entry) {
+        return entry.item == item;
+    });
 
-    if (const auto itemParent = qobject_cast<QQuickItem*>(quickParent))
-        m_menu->setProperty("parent", QVariant::fromValue(itemParent));
+    if (it == m_pendingEntries.end())
+        return false;
 
-    m_menu->setProperty("platformAgnosticMenu", QVariant::fromValue(this));
+    m_pendingEntries.erase(it);
+    return true;
 }
 
-QuickControls2Menu::QuickControls2Menu(QuickControls2Menu *parent)
-    : QuickControls2Menu{parent->m_menu, parent}
+void PlatformAgnosticMenu::clearPendingActions()
 {
-
+    m_pendingEntries.clear();
+    m_hibernated = false;
 }
 
-QuickControls2Menu::QuickControls2Menu(QQuickWindow *parent)
-    : QuickControls2Menu{parent->contentItem(), parent}
+bool PlatformAgnosticMenu::deferSeparator()
 {
+    if (m_pendingEntries.isEmpty())
+        return false;
 
+    m_pendingEntries.push_back({nullptr, true, {}});
+    return true;
 }
 
-QuickControls2Menu::QuickControls2Menu(QQuickItem *parent)
-    : QuickControls2Menu{parent, parent}
+void PlatformAgnosticMenu::materializePendingActions()
 {
+    if (m_pendingEntries.isEmpty())
+        return;
+
+    const auto pendingEntries = std::exchange(m_pendingEntries, {});
+    m_hibernated = false;
 
+    for (const auto& entry : pendingEntries)
+        materializeEntry(entry);
 }
 
-void QuickControls2Menu::installEventFilter(QObject *object)
+bool PlatformAgnosticMenu::materializePendingEntries(const QDeadlineTimer deadline)
 {
-    PlatformAgnosticMenu::installEventFilter(object);
-    assert(m_menu);
-    QQuickItem* const contentItem = m_menu->property("contentItem").value<QQuickItem*>();
-    assert(contentItem);
-    contentItem->installEventFilter(object);
+    if (!m_pendingEntries.isEmpty())
+        m_hibernated = false;
+
+    // The entries that are left stay after the native content, which keeps the order
+    while (!m_pendingEntries.isEmpty())
+    {
+        materializeEntry(m_pendingEntries.takeFirst());
+
+        if (deadline.hasExpired())
+            return m_pendingEntries.isEmpty();
+    }
+
+    return true;
 }
 
-void QuickControls2Menu::removeEventFilter(QObject *object)
+void PlatformAgnosticMenu::materializePendingActionsUntil(PlatformAgnosticAction *action)
 {
-    PlatformAgnosticMenu::removeEventFilter(object);
-    assert(m_menu);
-    QQuickItem* const contentItem = m_menu->property("contentItem").value<QQuickItem*>();
-    assert(contentItem);
-    contentItem->removeEventFilter(object);
+    const auto it = std::find_if(m_pendingEntries.cbegin(), m_pendingEntries.cend(), [action](const PendingEntry& entry) {
+        return !entry.isSeparator && entry.action == action;
+    });
+
+    if (it == m_pendingEntries.cend())
+        return;
+
+    m_hibernated = false;
+
+    for (auto count = std::distance(m_pendingEntries.cbegin(), it) + 1; count > 0; --count)
+        materializeEntry(m_pendingEntries.takeFirst());
 }
 
-void QuickControls2Menu::insertAction(PlatformAgnosticAction *before, PlatformAgnosticAction *action)
+void PlatformAgnosticMenu::materializeEntry(const PendingEntry &entry)
 {
-    if (!before)
+    if (entry.isSeparator)
     {
-        addAction(action);
+        addNativeSeparator();
         return;
     }
 
-    assert(m_menu);
-    assert(action);
-    assert(qobject_cast<QuickControls2Action*>(action));
+    if (entry.item)
+    {
+        addNativeItem(entry.item);
+        return;
+    }
 
-    // Akin to QWidgets::insertAction()
+    if (!entry.action)
+        return;
 
-    const auto& actionList = actions();
+    entry.action->materialize();
+    addNativeAction(entry.action);
+}
 
-    if (actionList.contains(action))
-        removeAction(action);
+void PlatformAgnosticMenu::actionAdded(PlatformAgnosticAction *action, PlatformAgnosticAction *before)
+{
+    assert(action);
+    assert(!action->m_menus.contains(this));
 
-    const int pos = actionList.indexOf(before);
+    const qsizetype pos = before ? m_actions.indexOf(before) : -1;
     if (pos >= 0)
-    {
-        QMetaObject::invokeMethod(m_menu.data(),
-                                  "_insertAction",
-                                  Q_ARG(int, pos),
-                                  Q_ARG(QObject*, static_cast<QuickControls2Action*>(action)->m_action));
-    }
+        m_actions.insert(pos, action);
     else
-    {
-        addAction(action);
-    }
+        m_actions.push_back(action);
+
+    action->m_menus.push_back(this);
+
+    if (action->isVisible())
+        ++m_visibleCount;
+
+    if (!m_textIndex)
+        return;
+
+    const QString text = action->logicalText();
+    m_textIndex->insert(action, text);
+
+    if (!m_filterText.isEmpty())
+        updateFilterMatch(action, text);
 }
 
-void QuickControls2Menu::addAction(PlatformAgnosticAction *action)
+void PlatformAgnosticMenu::actionRemoved(PlatformAgnosticAction *action)
 {
     assert(action);
-    assert(m_menu);
-    assert(qobject_cast<QuickControls2Action*>(action));
 
-    QMetaObject::invokeMethod(m_menu.data(),
-                              "_addAction",
-                              Q_ARG(QVariant,
-                                    QVariant::fromValue(static_cast<QuickControls2Action*>(action)->m_action.data())));
+    if (!m_actions.removeOne(action))
+        return;
+
+    action->m_menus.removeOne(this);
+    if (action != m_movingAction)
+        m_triggerHandlers.remove(action);
+
+    if (action->isVisible())
+        --m_visibleCount;
+
+    if (!m_textIndex)
+        return;
+
+    m_textIndex->remove(action);
+
+    m_filterMatches.remove(action);
+    if (action->m_filteredOut)
+        applyFilter({}, {action});
 }
 
-void QuickControls2Menu::removeAction(PlatformAgnosticAction *action)
+void PlatformAgnosticMenu::resetActions(const QList<PlatformAgnosticAction *> &actionList)
 {
-    assert(action);
-    assert(m_menu);
-    assert(qobject_cast<QuickControls2Action*>(action));
+    // The functors of the actions that stay are kept
+    auto triggerHandlers = std::exchange(m_triggerHandlers, {});
 
-    QMetaObject::invokeMethod(m_menu.data(),
-                              "_removeAction",
-                              Q_ARG(QVariant,
-                                    QVariant::fromValue(static_cast<QuickControls2Action*>(action)->m_action.data())));
+    const auto previousActions = m_actions;
+    for (const auto action : previousActions)
+        actionRemoved(action);
+
+    for (const auto action : actionList)
+    {
+        actionAdded(action);
+
+        const auto it = triggerHandlers.find(action);
+        if (it != triggerHandlers.end())
+            m_triggerHandlers.insert(action, std::move(it.value()));
+    }
 }
 
-void QuickControls2Menu::addMenu(PlatformAgnosticMenu *menu)
+void PlatformAgnosticMenu::setTriggerHandler(PlatformAgnosticAction *action, std::function<void(bool)> handler)
 {
-    assert(m_menu);
-    assert(qobject_cast<QuickControls2Menu*>(menu));
+    assert(action);
+    assert(action->m_menus.contains(this));
+
+    if (m_triggerHandlers.isEmpty())
+        connect(this, &PlatformAgnosticMenu::triggered, this, &PlatformAgnosticMenu::onTriggered, Qt::UniqueConnection);
 
-    QMetaObject::invokeMethod(m_menu.data(),
-                              "_addMenu",
-                              Q_ARG(QVariant,
-                                    QVariant::fromValue(static_cast<QuickControls2Menu*>(menu)->m_menu.data())));
+    m_triggerHandlers.insert(action, std::move(handler));
 }
 
-void QuickControls2Menu::popup(const QPoint &pos)
+void PlatformAgnosticMenu::onTriggered(PlatformAgnosticAction *action)
 {
-    assert(m_menu);
+    // Submenus report their actions as well, their functors are called by the submenu
+    const auto it = m_triggerHandlers.constFind(action);
+    if (it == m_triggerHandlers.cend())
+        return;
 
-    QPoint _pos = pos;
+    const bool checked = action->isChecked();
 
-    if (const auto parentItem = m_menu->property("parent").value<QQuickItem*>())
-    {
-        _pos = parentItem->mapFromGlobal(pos).toPoint();
-    }
+    // A copy, the functor may remove the action or destroy the menu
+    const auto handler = it.value();
+    handler(checked);
+}
 
-    m_menu->setProperty("x", _pos.x());
-    m_menu->setProperty("y", _pos.y());
+void PlatformAgnosticMenu::applyFilter(const QList<PlatformAgnosticAction *> &filteredOut,
+                                       const QList<PlatformAgnosticAction *> &filteredIn)
+{
+    for (const auto action : filteredOut)
+        action->setFilteredOut(true);
 
-    QMetaObject::invokeMethod(m_menu, "open");
+    for (const auto action : filteredIn)
+        action->setFilteredOut(false);
 }
 
-QList<PlatformAgnosticAction *> QuickControls2Menu::actions() const
+void PlatformAgnosticMenu::setFilter(const QString &text, const FilterMode mode)
 {
-    QList<PlatformAgnosticAction*> list;
+    PLATFORMAGNOSTIC_TRACE(MenuSetFilter, this, text, int(mode));
 
-    if (!m_menu)
-        return list;
+    if (text.isEmpty())
+    {
+        clearFilter();
+        return;
+    }
 
-    assert(m_menu->inherits("QQuickMenu"));
+    const auto matches = findActions(text, mode);
+    QSet<PlatformAgnosticAction*> matchSet{matches.cbegin(), matches.cend()};
 
-    const auto contentData = QQmlListReference(m_menu.data(), "contentData");
+    QList<PlatformAgnosticAction*> filteredOut;
+    QList<PlatformAgnosticAction*> filteredIn;
 
-    for (auto i = 0; i < contentData.count(); ++i)
+    if (m_filterText.isEmpty())
     {
-        const auto action = contentData.at(i)->property("action").value<QObject*>();
-        if (action)
+        // Nothing is filtered out yet
+        for (const auto action : std::as_const(m_actions))
         {
-            assert(action->inherits("QQuickAction"));
+            if (!matchSet.contains(action))
+                filteredOut.push_back(action);
+        }
+    }
+    else
+    {
+        // Only the previous and the current matches can change state
+        for (const auto action : std::as_const(m_filterMatches))
+        {
+            if (!matchSet.contains(action))
+                filteredOut.push_back(action);
+        }
 
-            if (const auto platformAgnosticAction = action->property("platformAgnosticAction").value<PlatformAgnosticAction*>())
-                list.push_back(platformAgnosticAction);
+        for (const auto action : matches)
+        {
+            if (!m_filterMatches.contains(action))
+                filteredIn.push_back(action);
         }
     }
 
-    return list;
-}
+    m_filterText = text;
+    m_normalizedFilterText = PlatformAgnosticTextIndex::normalize(text);
+    m_filterMode = mode;
+    m_filterMatches = std::move(matchSet);
 
-void QuickControls2Menu::close()
-{
-    assert(m_menu);
-    QMetaObject::invokeMethod(m_menu, "close");
+    applyFilter(filteredOut, filteredIn);
+    pullShownActionStates(filteredIn);
 }
 
-void QuickControls2Menu::addSeparator()
+void PlatformAgnosticMenu::clearFilter()
 {
-    assert(m_menu);
-    assert(m_menuSeparatorComponent);
+    PLATFORMAGNOSTIC_TRACE(MenuClearFilter, this);
+
+    if (m_filterText.isEmpty())
+        return;
 
-    const auto separator = qobject_cast<QQuickItem*>(m_menuSeparatorComponent->create(qmlContext(m_menu)));
-    assert(separator);
-    QQmlEngine::setObjectOwnership(separator, QQmlEngine::CppOwnership);
+    QList<PlatformAgnosticAction*> filteredIn;
 
-    assert(separator->inherits("QQuickMenuSeparator"));
-    separator->setParent(m_menu);
+    for (const auto action : std::as_const(m_actions))
+    {
+        if (action->m_filteredOut)
+            filteredIn.push_back(action);
+    }
 
-    addItem(separator);
+    m_filterText.clear();
+    m_normalizedFilterText.clear();
+    m_filterMatches.clear();
+
+    applyFilter({}, filteredIn);
+    pullShownActionStates(filteredIn);
 }
 
-QSize QuickControls2Menu::sizeHint() const
+QList<PlatformAgnosticAction *> PlatformAgnosticMenu::findActions(const QString &text, const FilterMode mode) const
 {
-    assert(m_menu);
-    // We have to polish the item view otherwise implicit size is reported incorrectly.
-    // As an optimization, Qt does not calculate the item view content size until
-    // it becomes necessary.
-    if (const auto contentItem = m_menu->property("contentItem").value<QQuickItem*>())
-    {
-#if QT_VERSION >= QT_VERSION_CHECK(6, 3, 0)
-        // Qt 6.3.0 has ensurePolished(), which calls updatePolish()
-        contentItem->ensurePolished();
-#else
-        // Before Qt 6.3.0, we can not use updatePolish() because it is protected.
-        // There are several alternatives, such as calling polish() and waiting
-        // until the window signals QQuickWindow::beforeSynchronizing.
-        // Another alternative is calling componentComplete(), which in turn
-        // calls updateViewport() that calculates the content size. Here,
-        // the invokable QQuickItemView::forceLayout() is used.
-        assert(contentItem->inherits("QQuickItemView"));
-        QMetaObject::invokeMethod(contentItem, "forceLayout");
-#endif
-    }
+    ensureTextIndex();
 
-    return QSizeF{m_menu->property("implicitWidth").value<qreal>(),
-                  m_menu->property("implicitHeight").value<qreal>()}.toSize();
+    if (mode == FilterMode::Prefix)
+        return m_textIndex->matchPrefix(text);
+    else
+        return m_textIndex->matchSubstring(text);
 }
 
-void QuickControls2Menu::setTearOffEnabled(bool enabled)
+void PlatformAgnosticMenu::ensureTextIndex() const
 {
-    // Stub
-    Q_UNUSED(enabled);
-    qmlDebug(m_menu.data()) << "Tear off is not supported by QuickControls2Menu!";
+    if (m_textIndex)
+        return;
+
+    m_textIndex = std::make_unique<PlatformAgnosticTextIndex>();
+
+    for (const auto action : std::as_const(m_actions))
+        m_textIndex->insert(action, action->logicalText());
 }
 
-void QuickControls2Menu::addItem(QObject *item)
+void PlatformAgnosticMenu::updateFilterMatch(PlatformAgnosticAction *action, const QString &text)
 {
-    assert(m_menu);
-    assert(qobject_cast<QQuickItem*>(item));
+    const QString normalizedText = PlatformAgnosticTextIndex::normalize(text);
+
+    const bool match = (m_filterMode == FilterMode::Prefix) ? normalizedText.startsWith(m_normalizedFilterText)
+                                                            : normalizedText.contains(m_normalizedFilterText);
 
-    QMetaObject::invokeMethod(m_menu, "addItem", Q_ARG(QQuickItem*, static_cast<QQuickItem*>(item)));
+    if (match)
+    {
+        m_filterMatches.insert(action);
+        if (action->m_filteredOut)
+        {
+            applyFilter({}, {action});
+            pullShownActionStates({action});
+        }
+    }
+    else
+    {
+        m_filterMatches.remove(action);
+        if (!action->m_filteredOut)
+            applyFilter({action}, {});
+    }
 }
 
-void QuickControls2Menu::removeItem(QObject* item)
+void PlatformAgnosticMenu::onActionTextChanged(PlatformAgnosticAction *action, const QString &text)
 {
-    assert(m_menu);
-    assert(qobject_cast<QQuickItem*>(item));
+    if (!m_textIndex)
+        return;
+
+    m_textIndex->insert(action, text);
 
-    QMetaObject::invokeMethod(m_menu, "removeItem", Q_ARG(QQuickItem*, static_cast<QQuickItem*>(item)));
+    if (!m_filterText.isEmpty())
+        updateFilterMatch(action, text);
 }
 
-QObject* QuickControls2Menu::menu() const
+void PlatformAgnosticMenu::onActionVisibleChanged(PlatformAgnosticAction *action, const bool visible)
 {
-    return m_menu.data();
+    if (visible)
+        ++m_visibleCount;
+    else
+        --m_visibleCount;
+
+    // Matched again against its logical text, so that a shown action that
+    // matches the filter is not left filtered out
+    if (m_textIndex && !m_filterText.isEmpty())
+        updateFilterMatch(action, action->logicalText());
+
+    if (visible)
+        pullShownActionStates({action});
 }
 
-void QuickControls2Menu::setMenu(QObject *menu)
+void PlatformAgnosticMenu::onActionDestroyed(PlatformAgnosticAction *action)
 {
-    assert(menu);
-    assert(menu->inherits("QQuickMenu"));
-    m_menu = menu;
+    // The action is being destroyed, only the parts of the base class are accessed
+    removePendingAction(action);
+
+    m_actions.removeOne(action);
+    action->m_menus.removeOne(this);
+    m_triggerHandlers.remove(action);
+
+    if (action->isVisible())
+        --m_visibleCount;
+
+    if (m_textIndex)
+        m_textIndex->remove(action);
+
+    m_filterMatches.remove(action);
 }
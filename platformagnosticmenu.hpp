@@ -25,10 +25,23 @@
 
 #include <QObject>
 #include <QPointer>
+#include <QHash>
 #include <QList>
+#include <QSet>
 #include <QKeySequence>
+#include <QDeadlineTimer>
 
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+#include "platformagnosticaccounting.hpp"
 #include "platformagnosticaction.hpp"
+#include "platformagnosticarena.hpp"
+#include "platformagnosticeventhook.hpp"
+#include "platformagnostictextindex.hpp"
+
+class QTimer;
 
 // Common denominator for QMenu and QQuickMenu
 class PlatformAgnosticMenu : public QObject
@@ -37,24 +50,65 @@ class PlatformAgnosticMenu : public QObject
 
     friend class PlatformAgnosticAction;
     friend class PlatformAgnosticActionGroup;
+    friend class PlatformAgnosticArena;
 
 public:
+    enum class FilterMode
+    {
+        Prefix,
+        Substring
+    };
+    Q_ENUM(FilterMode)
+
+    enum class Backend
+    {
+        Widgets,
+        QuickControls2,
+        // Keeps the state in plain objects, for tests and benchmarks without a display
+        Null
+    };
+    Q_ENUM(Backend)
+
     explicit PlatformAgnosticMenu(QObject *parent);
-    virtual ~PlatformAgnosticMenu() = default;
+    virtual ~PlatformAgnosticMenu();
+
+    static void* operator new(std::size_t size) { return PlatformAgnosticArena::allocate(size); }
+    static void operator delete(void* pointer) { PlatformAgnosticArena::deallocate(pointer); }
 
     virtual void installEventFilter(QObject* object);
     virtual void removeEventFilter(QObject* object);
 
+    // Calls handler for the events of the given type that the native menu receives,
+    // returning true filters the event out. Unlike installEventFilter(), the handler
+    // does not see the other events, and all handlers share a single event filter.
+    int addEventHandler(QEvent::Type type, PlatformAgnosticEventHook::Handler handler);
+    void removeEventHandler(int id);
+
     template<class Menu>
     static PlatformAgnosticMenu* fromMenu(Menu menu);
 
     static PlatformAgnosticMenu* createMenu(QObject * parent = nullptr);
     static PlatformAgnosticMenu* createMenu(const QString& text, QObject * parent);
 
+    // Backend of the menus, actions and action groups created without a parent.
+    // QuickControls2 needs a parent, so it can not be the default.
+    static void setDefaultBackend(Backend backend);
+    static Backend defaultBackend();
+
     virtual PlatformAgnosticMenu *addMenu(const QString &title);
     virtual void addMenu(PlatformAgnosticMenu *menu) = 0;
 
     virtual void setTearOffEnabled(bool enabled) = 0;
+    // Trades the show and hide animations for latency. The content is laid out while
+    // the menu is hidden, so that popup() only has to position it. The lazy actions
+    // are then created ahead of the first show.
+    virtual void setFastPopup(bool enabled) = 0;
+    // Gives the native menu at most size visible entries at a time, with entries to
+    // page through the others, for menus with thousands of actions. actions() still
+    // lists all of them. 0, the default, disables it. Only WidgetsMenu pages, QQuickMenu
+    // scrolls its content instead.
+    virtual void setPageSize(int size);
+    int pageSize() const { return m_pageSize; }
     virtual void clear();
     virtual bool isEmpty() const;
     virtual void setTitle(const QString& title);
@@ -71,16 +125,70 @@ public:
     virtual PlatformAgnosticAction* addAction(const QString& iconSource, const QString& text);
     virtual void removeAction(PlatformAgnosticAction *action) = 0;
 
-    virtual QList<PlatformAgnosticAction*> actions() const = 0;
+    // The returned list shares the data of the index of the menu, and does not allocate
+    virtual QList<PlatformAgnosticAction*> actions() const;
+
+    template<typename Functor>
+    void forEachAction(Functor func) const
+    {
+        // Sharing the list keeps the iteration safe against changes made by func
+        const auto actionList = m_actions;
+        for (const auto action : actionList)
+            func(action);
+    }
+
+    qsizetype count() const { return m_actions.size(); }
+    qsizetype visibleCount() const { return m_visibleCount; }
+    // O(1), the action keeps track of the menus it is in
+    bool containsAction(PlatformAgnosticAction* action) const;
+
+    // Hides the actions that do not match the text. Matching is case and diacritic
+    // insensitive, and is done through an index that is kept up to date by setText().
+    void setFilter(const QString& text, FilterMode mode = FilterMode::Substring);
+    void clearFilter();
+    QString filter() const { return m_filterText; }
+    QList<PlatformAgnosticAction*> findActions(const QString& text, FilterMode mode = FilterMode::Substring) const;
 
     virtual QSize sizeHint() const = 0;
 
+    // Runs updates, which change the actions of the menu, with at most
+    // one relayout of the native menu if it is shown
+    virtual void batchUpdates(const std::function<void()>& updates);
+
+    using ContentProvider = std::function<void(PlatformAgnosticMenu* menu)>;
+    // Fills the menu once, before it is first shown. Until then, the menu is built
+    // speculatively in idle time when its parent menu is shown, and first of all when
+    // its entry is hovered. See PlatformAgnosticSpeculativeBuilder.
+    void setContentProvider(ContentProvider provider);
+    // Clears the menu, the provider fills it again before it is shown next
+    void invalidateContent();
+    // Calls the provider if needed, then creates the native content of the pending
+    // entries until the deadline. Returns true once the menu is built and laid out.
+    bool buildContent(QDeadlineTimer deadline = QDeadlineTimer{QDeadlineTimer::Forever});
+    bool needsBuild() const;
+
+    // Releases the native actions, separators and items of the menu once it has been
+    // hidden for msec milliseconds. The menu keeps them as lazy pending entries, which
+    // are created again on the next popup. A negative delay, the default, disables it.
+    // The actions with a shortcut keep their native action, so that the shortcut
+    // still works while the menu is hibernated.
+    void setHibernationDelay(int msec);
+    int hibernationDelay() const { return m_hibernationDelay; }
+    // Returns the heap bytes reclaimed, or -1 if the platform can not tell
+    qint64 hibernate();
+    bool isHibernated() const { return m_hibernated; }
+
+    // What the menu holds, for PlatformAgnosticAccounting::snapshot()
+    virtual PlatformAgnosticAccounting::Usage usage() const;
+
     template<typename Functor>
     PlatformAgnosticAction* addAction(const QString& text, Functor func, const QKeySequence &shortcut = 0)
     {
         const auto action = addAction(text);
         action->setShortcut(shortcut);
-        connect(action, &PlatformAgnosticAction::triggered, func);
+        setTriggerHandler(action, [func](const bool checked) mutable {
+            invokeTriggerHandler(func, checked);
+        });
         return action;
     }
 
@@ -89,7 +197,24 @@ public:
     {
         const auto action = addAction(text);
         action->setShortcut(shortcut);
-        connect(action, &PlatformAgnosticAction::triggered, context, func);
+
+        // Like a connection, nothing is called once the context is destroyed
+        setTriggerHandler(action, [guard = QPointer<const QObject>(context), context, func](const bool checked) mutable {
+            if (!guard)
+                return;
+
+            if constexpr (std::is_member_function_pointer_v<Functor>)
+            {
+                if constexpr (std::is_invocable_v<Functor, Object, bool>)
+                    std::invoke(func, context, checked);
+                else
+                    std::invoke(func, context);
+            }
+            else
+            {
+                invokeTriggerHandler(func, checked);
+            }
+        });
         return action;
     }
 
@@ -121,98 +246,146 @@ signals:
     void aboutToShow();
     void aboutToHide();
 
+    // Emitted for the actions of the menu and its submenus, one connection
+    // here can replace connecting to each action
+    void triggered(PlatformAgnosticAction* action);
+    void hovered(PlatformAgnosticAction* action);
+
+    void hibernated(qint64 reclaimedBytes);
+
 protected:
     QObject* operator()() const { return menu(); };
     virtual QObject* menu() const = 0;
     virtual void setMenu(QObject* menu) = 0;
-};
-
-class WidgetsMenu : public PlatformAgnosticMenu
-{
-    Q_OBJECT
 
-public:
-    explicit WidgetsMenu(WidgetsMenu* parent = nullptr);
-    virtual ~WidgetsMenu();
-
-    void insertAction(PlatformAgnosticAction *before, PlatformAgnosticAction *action) override;
-
-    void clear() override;
-
-    void addAction(PlatformAgnosticAction *action) override;
-    void removeAction(PlatformAgnosticAction *action) override;
-
-    void addMenu(PlatformAgnosticMenu *menu) override;
-
-    void popup(const QPoint& pos) override;
+    // Whether the native menu is shown. The default implementation reads the
+    // 'visible' property, which QMenu and QQuickMenu share.
+    virtual bool isNativeVisible() const;
 
-    QList<PlatformAgnosticAction*> actions() const override;
+    // The native objects that event filters and handlers are installed on
+    virtual QList<QObject*> eventTargets() const;
+    // Called by the implementations when the native menu changes
+    void updateEventTargets();
 
-    void close() override;
+    virtual void addNativeAction(PlatformAgnosticAction* action) = 0;
+    virtual void addNativeSeparator() = 0;
+    virtual void addNativeItem(QObject* item) = 0;
 
-    void addSeparator() override;
-
-    QSize sizeHint() const override;
-
-    void setTearOffEnabled(bool enabled) override;
-
-    void addItem(QObject* item) override;
-    void removeItem(QObject* item) override;
-
-protected:
-    QObject* menu() const override;
-    void setMenu(QObject * menu) override;
+    // A lazy action, a separator if isSeparator is set, or an item kept by hibernate()
+    struct PendingEntry
+    {
+        QPointer<PlatformAgnosticAction> action;
+        bool isSeparator = false;
+        QPointer<QObject> item;
+    };
+
+    // Removes the content of the native menu for hibernate(), and describes it in order.
+    // The actions are dematerialized by the base class, separators can be destroyed.
+    virtual QList<PendingEntry> takeNativeContent() = 0;
+
+    // Called by the implementations whenever an action is added to or removed from the menu
+    void actionAdded(PlatformAgnosticAction* action, PlatformAgnosticAction* before = nullptr);
+    void actionRemoved(PlatformAgnosticAction* action);
+    // Replaces the index, used when a native menu with content is wrapped
+    void resetActions(const QList<PlatformAgnosticAction*>& actionList);
+    // Set by the implementations while an action in the menu is removed to be added
+    // again elsewhere in it, so that actionRemoved() keeps its addAction() functor
+    PlatformAgnosticAction* m_movingAction = nullptr;
+
+    // Called by the implementations when the entry of a submenu is hovered
+    void submenuHovered(PlatformAgnosticMenu* submenu);
+
+    // Changes the filtered out state of the actions, in one go
+    virtual void applyFilter(const QList<PlatformAgnosticAction*>& filteredOut,
+                             const QList<PlatformAgnosticAction*>& filteredIn);
+
+    // Keeps a lazy action pending instead of adding it to the native menu.
+    // Returns false if the action should be added to the native menu right away.
+    bool deferAction(PlatformAgnosticAction* action);
+    bool removePendingAction(PlatformAgnosticAction* action);
+    bool removePendingItem(QObject* item);
+    void clearPendingActions();
+    // Keeps a separator pending behind the pending actions, so that it costs nothing
+    // until the menu is shown. Returns false if there are no pending actions.
+    bool deferSeparator();
+
+protected slots:
+    // Creates the native actions of the pending lazy actions, and adds them
+    // and the pending separators to the native menu.
+    void materializePendingActions();
+
+private slots:
+    void onAboutToShow();
+    void onHibernationTimeout();
+    void onTriggered(PlatformAgnosticAction* action);
 
 private:
-    QPointer<class QMenu> m_menu;
-};
-
-class QuickControls2Menu : public PlatformAgnosticMenu
-{
-    Q_OBJECT
-
-public:
-    QuickControls2Menu(QObject* quickParent, class QObject* parent = nullptr);
-    virtual ~QuickControls2Menu() = default;
+    // The functors of the addAction() overloads are called from triggered(), rather than
+    // connecting each action. A functor is dropped when its action leaves the menu.
+    void setTriggerHandler(PlatformAgnosticAction* action, std::function<void(bool)> handler);
 
-    explicit QuickControls2Menu(QuickControls2Menu *parent);
-    explicit QuickControls2Menu(class QQuickWindow* parent);
-    explicit QuickControls2Menu(class QQuickItem* parent);
+    template<typename Functor>
+    static void invokeTriggerHandler(Functor& func, const bool checked)
+    {
+        if constexpr (std::is_invocable_v<Functor&, bool>)
+            func(checked);
+        else
+            func();
+    }
 
-    virtual void installEventFilter(QObject* object) override;
-    virtual void removeEventFilter(QObject* object) override;
+    // Called by PlatformAgnosticAction for the menus it is in
+    void onActionTextChanged(PlatformAgnosticAction* action, const QString& text);
+    void onActionVisibleChanged(PlatformAgnosticAction* action, bool visible);
+    void onActionDestroyed(PlatformAgnosticAction* action);
 
-    void insertAction(PlatformAgnosticAction *before, PlatformAgnosticAction *action) override;
+    // Materializes the pending entries up to and including the action
+    void materializePendingActionsUntil(PlatformAgnosticAction* action);
+    // Materializes the pending entries one by one, returns false if the deadline expires first
+    bool materializePendingEntries(QDeadlineTimer deadline);
+    // Evaluates the state providers of the visible actions, and writes the changes in one batch
+    void pullActionStates(const QList<PlatformAgnosticAction*>& actionList);
+    // For the actions that show up while the menu is open
+    void pullShownActionStates(const QList<PlatformAgnosticAction*>& actionList);
+    void materializeEntry(const PendingEntry& entry);
 
-    void addAction(PlatformAgnosticAction *action) override;
-    void removeAction(PlatformAgnosticAction *action) override;
+    void ensureTextIndex() const;
+    void updateFilterMatch(PlatformAgnosticAction* action, const QString& text);
 
-    void addMenu(PlatformAgnosticMenu *menu) override;
+    // Actions in the order of the menu, including the pending ones
+    QList<PlatformAgnosticAction*> m_actions;
+    qsizetype m_visibleCount = 0;
 
-    void popup(const QPoint& pos) override;
+    // Pending entries always come after the native content of the menu,
+    // so adding them in order once they are materialized keeps the order.
+    QList<PendingEntry> m_pendingEntries;
 
-    QList<PlatformAgnosticAction*> actions() const override;
+    QHash<PlatformAgnosticAction*, std::function<void(bool)>> m_triggerHandlers;
 
-    void close() override;
+    // Created on the first search
+    mutable std::unique_ptr<PlatformAgnosticTextIndex> m_textIndex;
 
-    void addSeparator() override;
+    QString m_filterText;
+    QString m_normalizedFilterText;
+    FilterMode m_filterMode = FilterMode::Substring;
+    QSet<PlatformAgnosticAction*> m_filterMatches;
 
-    QSize sizeHint() const override;
+    // Created when the first event handler is added
+    QPointer<PlatformAgnosticEventHook> m_eventHook;
 
-    void setTearOffEnabled(bool enabled) override;
+    // Owned, set by the first PlatformAgnosticArena::Scope of the menu
+    PlatformAgnosticArena* m_arena = nullptr;
 
-    void addItem(QObject* item) override;
-    void removeItem(QObject* item) override;
+    ContentProvider m_contentProvider;
+    bool m_contentBuilt = false;
 
-protected:
-    QObject* menu() const override;
-    void setMenu(QObject * menu) override;
+    // Created by the first setHibernationDelay()
+    QTimer* m_hibernationTimer = nullptr;
+    int m_hibernationDelay = -1;
+    bool m_hibernated = false;
 
-private:
-    QPointer<QObject> m_menu;
+    int m_pageSize = 0;
 
-    QPointer<class QQmlComponent> m_menuComponent;
-    QPointer<class QQmlComponent> m_menuSeparatorComponent;
+    PlatformAgnosticAccounting::Entry m_accountingEntry{this};
 };
 
 #endif // PLATFORMAGNOSTICMENU_HPP
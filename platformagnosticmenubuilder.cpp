@@ -0,0 +1,175 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "platformagnosticmenubuilder.hpp"
+
+#include <QMetaObject>
+#include <QThread>
+
+#include <cassert>
+#include <optional>
+
+#include "platformagnosticmenu.hpp"
+#include "platformagnosticaction.hpp"
+
+class PlatformAgnosticMenuBuilderData : public QSharedData
+{
+public:
+    struct Entry
+    {
+        enum class Type
+        {
+            Action,
+            Separator,
+            Menu
+        };
+
+        Type type;
+        PlatformAgnosticMenuBuilder::Action action;
+        // Only set for submenus, an empty builder would allocate its data
+        std::optional<PlatformAgnosticMenuBuilder> menu;
+    };
+
+    QList<Entry> entries;
+};
+
+PlatformAgnosticMenuBuilder::PlatformAgnosticMenuBuilder()
+    : d{new PlatformAgnosticMenuBuilderData}
+{
+
+}
+
+PlatformAgnosticMenuBuilder::PlatformAgnosticMenuBuilder(const PlatformAgnosticMenuBuilder &other) = default;
+PlatformAgnosticMenuBuilder &PlatformAgnosticMenuBuilder::operator=(const PlatformAgnosticMenuBuilder &other) = default;
+PlatformAgnosticMenuBuilder::~PlatformAgnosticMenuBuilder() = default;
+
+PlatformAgnosticMenuBuilder &PlatformAgnosticMenuBuilder::addAction(const Action &action)
+{
+    d->entries.push_back({PlatformAgnosticMenuBuilderData::Entry::Type::Action, action, std::nullopt});
+    return *this;
+}
+
+PlatformAgnosticMenuBuilder &PlatformAgnosticMenuBuilder::addAction(const QString &text, const QVariant &data)
+{
+    Action action;
+    action.text = text;
+    action.data = data;
+    return addAction(action);
+}
+
+PlatformAgnosticMenuBuilder &PlatformAgnosticMenuBuilder::addSeparator()
+{
+    d->entries.push_back({PlatformAgnosticMenuBuilderData::Entry::Type::Separator, {}, std::nullopt});
+    return *this;
+}
+
+PlatformAgnosticMenuBuilder &PlatformAgnosticMenuBuilder::addMenu(const QString &title, const PlatformAgnosticMenuBuilder &menu)
+{
+    Action action;
+    action.text = title;
+    d->entries.push_back({PlatformAgnosticMenuBuilderData::Entry::Type::Menu, action, menu});
+    return *this;
+}
+
+PlatformAgnosticMenuBuilder &PlatformAgnosticMenuBuilder::append(const PlatformAgnosticMenuBuilder &other)
+{
+    d->entries.append(other.d->entries);
+    return *this;
+}
+
+bool PlatformAgnosticMenuBuilder::isEmpty() const
+{
+    return d->entries.isEmpty();
+}
+
+qsizetype PlatformAgnosticMenuBuilder::count() const
+{
+    return d->entries.size();
+}
+
+QList<PlatformAgnosticAction *> PlatformAgnosticMenuBuilder::build(PlatformAgnosticMenu *menu) const
+{
+    assert(menu);
+    assert(menu->thread() == QThread::currentThread());
+
+    QList<PlatformAgnosticAction*> actionList;
+    build(menu, actionList);
+    return actionList;
+}
+
+void PlatformAgnosticMenuBuilder::build(PlatformAgnosticMenu *menu, QList<PlatformAgnosticAction *> &actionList) const
+{
+    // The actions are lazy, so a hidden menu creates their native actions in one pass
+    // when it is shown, and a visible one is laid out once for the whole content
+    menu->batchUpdates([this, menu, &actionList]() {
+        for (const auto& entry : std::as_const(d->entries))
+        {
+            switch (entry.type)
+            {
+            case PlatformAgnosticMenuBuilderData::Entry::Type::Action:
+            {
+                const auto& description = entry.action;
+                const auto action = PlatformAgnosticAction::createLazyAction(menu);
+
+                action->setText(description.text);
+                if (!description.icon.isEmpty())
+                    action->setIcon(description.icon, description.iconIsSource);
+                if (!description.shortcut.isEmpty())
+                    action->setShortcut(description.shortcut);
+                if (description.data.isValid())
+                    action->setData(description.data);
+                if (description.checkable)
+                {
+                    action->setCheckable(true);
+                    action->setChecked(description.checked);
+                }
+                if (!description.enabled)
+                    action->setEnabled(false);
+
+                menu->addAction(action);
+                actionList.push_back(action);
+                break;
+            }
+            case PlatformAgnosticMenuBuilderData::Entry::Type::Separator:
+                menu->addSeparator();
+                break;
+            case PlatformAgnosticMenuBuilderData::Entry::Type::Menu:
+                assert(entry.menu);
+                entry.menu->build(menu->addMenu(entry.action.text), actionList);
+                break;
+            }
+        }
+    });
+}
+
+void PlatformAgnosticMenuBuilder::commit(PlatformAgnosticMenu *menu,
+                                         std::function<void (const QList<PlatformAgnosticAction *> &)> done) const
+{
+    assert(menu);
+
+    // The menu is the context of the call, so the call is dropped if the menu is destroyed
+    QMetaObject::invokeMethod(menu, [menu, builder = *this, done = std::move(done)]() {
+        const auto actionList = builder.build(menu);
+        if (done)
+            done(actionList);
+    }, Qt::QueuedConnection);
+}
@@ -0,0 +1,87 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef PLATFORMAGNOSTICMENUBUILDER_HPP
+#define PLATFORMAGNOSTICMENUBUILDER_HPP
+
+#include <QString>
+#include <QVariant>
+#include <QKeySequence>
+#include <QList>
+#include <QSharedDataPointer>
+
+#include <functional>
+
+class PlatformAgnosticMenu;
+class PlatformAgnosticAction;
+class PlatformAgnosticMenuBuilderData;
+
+// Describes the content of a menu without creating any QObject, so that it can be
+// filled on worker threads. Builders are implicitly shared values: each thread fills
+// its own, and they can be combined with append(). The menu is populated later on
+// its own thread by commit() or build().
+class PlatformAgnosticMenuBuilder
+{
+public:
+    struct Action
+    {
+        QString text;
+        QString icon;
+        bool iconIsSource = true;
+        QKeySequence shortcut;
+        QVariant data;
+        bool enabled = true;
+        bool checkable = false;
+        bool checked = false;
+    };
+
+    PlatformAgnosticMenuBuilder();
+    PlatformAgnosticMenuBuilder(const PlatformAgnosticMenuBuilder& other);
+    PlatformAgnosticMenuBuilder& operator=(const PlatformAgnosticMenuBuilder& other);
+    ~PlatformAgnosticMenuBuilder();
+
+    PlatformAgnosticMenuBuilder& addAction(const Action& action);
+    PlatformAgnosticMenuBuilder& addAction(const QString& text, const QVariant& data = {});
+    PlatformAgnosticMenuBuilder& addSeparator();
+    PlatformAgnosticMenuBuilder& addMenu(const QString& title, const PlatformAgnosticMenuBuilder& menu);
+    PlatformAgnosticMenuBuilder& append(const PlatformAgnosticMenuBuilder& other);
+
+    bool isEmpty() const;
+    qsizetype count() const;
+
+    // Must be called on the thread of menu. Creates lazy actions inside batchUpdates().
+    // Returns the created actions, in order, including the ones of the submenus.
+    QList<PlatformAgnosticAction*> build(PlatformAgnosticMenu* menu) const;
+
+    // Can be called on any thread. The content is built in one go by a queued call
+    // on the thread of menu, then done is called there with the created actions.
+    // Nothing is built if the menu is destroyed in the meantime.
+    void commit(PlatformAgnosticMenu* menu,
+                std::function<void(const QList<PlatformAgnosticAction*>&)> done = {}) const;
+
+private:
+    void build(PlatformAgnosticMenu* menu, QList<PlatformAgnosticAction*>& actionList) const;
+
+    QSharedDataPointer<PlatformAgnosticMenuBuilderData> d;
+};
+
+#endif // PLATFORMAGNOSTICMENUBUILDER_HPP
@@ -0,0 +1,46 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef PLATFORMAGNOSTICMENUS_HPP
+#define PLATFORMAGNOSTICMENUS_HPP
+
+// Includes the core and the backends the program links against. The backend
+// targets define PLATFORMAGNOSTICMENUS_WIDGETS and PLATFORMAGNOSTICMENUS_QUICKCONTROLS2.
+
+#include "platformagnosticmenu.hpp"
+#include "platformagnosticaction.hpp"
+#include "platformagnosticactiongroup.hpp"
+#include "platformagnosticaccounting.hpp"
+#include "platformagnosticmrusection.hpp"
+#include "platformagnosticnull.hpp"
+#include "platformagnosticspeculativebuilder.hpp"
+#include "platformagnostictrace.hpp"
+
+#ifdef PLATFORMAGNOSTICMENUS_WIDGETS
+#include "platformagnosticwidgets.hpp"
+#endif
+
+#ifdef PLATFORMAGNOSTICMENUS_QUICKCONTROLS2
+#include "platformagnosticquickcontrols2.hpp"
+#endif
+
+#endif // PLATFORMAGNOSTICMENUS_HPP
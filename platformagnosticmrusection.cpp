@@ -0,0 +1,190 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "platformagnosticmrusection.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include "platformagnosticmenu.hpp"
+#include "platformagnosticaction.hpp"
+
+PlatformAgnosticMruSection::PlatformAgnosticMruSection(PlatformAgnosticMenu *menu, const int capacity)
+    : QObject{menu}
+    , m_menu{menu}
+{
+    assert(menu);
+    assert(capacity > 0);
+
+    m_actions.reserve(capacity);
+    m_entries.reserve(capacity);
+
+    for (int i = 0; i < capacity; ++i)
+    {
+        // A hidden action keeps a text, see PlatformAgnosticAction::setVisible().
+        // Created for the backend of the menu, then owned by the section, so that
+        // clearing the menu does not delete it.
+        const auto action = PlatformAgnosticAction::createLazyAction(QString::number(i + 1), menu);
+        action->setParent(this);
+        action->setVisible(false);
+        menu->addAction(action);
+        m_actions.push_back(action);
+    }
+
+    // One connection for the section rather than one per action
+    connect(menu, &PlatformAgnosticMenu::triggered, this, &PlatformAgnosticMruSection::onTriggered);
+    // After the content provider, which the menu calls first
+    connect(menu, &PlatformAgnosticMenu::aboutToShow, this, &PlatformAgnosticMruSection::onAboutToShow);
+}
+
+int PlatformAgnosticMruSection::indexOf(const QString &text, const QVariant &data) const
+{
+    const auto it = std::find_if(m_entries.cbegin(), m_entries.cend(), [&](const Entry& e) {
+        return data.isValid() ? (e.data == data) : (e.text == text);
+    });
+
+    return (it == m_entries.cend()) ? -1 : static_cast<int>(it - m_entries.cbegin());
+}
+
+void PlatformAgnosticMruSection::touch(const QString &text, const QVariant &data)
+{
+    const int index = indexOf(text, data);
+
+    if (index == 0)
+    {
+        if (m_entries.front().text == text)
+            return;
+
+        m_entries.front().text = text;
+        updateActions(0, 1);
+        return;
+    }
+
+    if (index > 0)
+    {
+        // The entries above it move down by one
+        std::rotate(m_entries.begin(), m_entries.begin() + index, m_entries.begin() + index + 1);
+        m_entries.front().text = text;
+        updateActions(0, index + 1);
+        return;
+    }
+
+    // Over the oldest entry once the section is full
+    if (count() < capacity())
+        m_entries.push_back({text, data});
+    else
+        m_entries.back() = {text, data};
+
+    std::rotate(m_entries.begin(), m_entries.end() - 1, m_entries.end());
+    updateActions(0, count());
+}
+
+bool PlatformAgnosticMruSection::remove(const QString &text, const QVariant &data)
+{
+    const int index = indexOf(text, data);
+    if (index < 0)
+        return false;
+
+    // The entries below it move up by one
+    m_entries.erase(m_entries.begin() + index);
+
+    updateActions(index, count() + 1);
+    return true;
+}
+
+void PlatformAgnosticMruSection::clear()
+{
+    const int previousCount = count();
+    m_entries.clear();
+
+    updateActions(0, previousCount);
+}
+
+QString PlatformAgnosticMruSection::text(const int index) const
+{
+    assert(index >= 0 && index < count());
+    return m_entries[index].text;
+}
+
+QVariant PlatformAgnosticMruSection::data(const int index) const
+{
+    assert(index >= 0 && index < count());
+    return m_entries[index].data;
+}
+
+void PlatformAgnosticMruSection::updateActions(const int first, const int last)
+{
+    if (!m_menu)
+        return;
+
+    m_menu->batchUpdates([this, first, last]() {
+        for (int i = first; i < last; ++i)
+        {
+            const auto& action = m_actions.at(i);
+            if (!action)
+                continue;
+
+            // The actions after the last entry are hidden with their previous text
+            if (i < count())
+            {
+                action->setText(m_entries[i].text);
+                action->setData(m_entries[i].data);
+                action->setVisible(true);
+            }
+            else
+            {
+                action->setVisible(false);
+                action->setData({});
+            }
+        }
+    });
+}
+
+void PlatformAgnosticMruSection::onTriggered(PlatformAgnosticAction *action)
+{
+    const qsizetype index = m_actions.indexOf(action);
+    if (index < 0 || index >= count())
+        return;
+
+    const auto& e = m_entries[index];
+    emit triggered(e.text, e.data);
+}
+
+void PlatformAgnosticMruSection::onAboutToShow()
+{
+    // The menu was cleared since the section was added
+    bool added = false;
+
+    for (const auto& action : std::as_const(m_actions))
+    {
+        if (action && !m_menu->containsAction(action))
+        {
+            m_menu->addAction(action);
+            added = true;
+        }
+    }
+
+    // The content was already built for this show
+    if (added)
+        m_menu->buildContent();
+}
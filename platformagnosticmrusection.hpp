@@ -0,0 +1,87 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef PLATFORMAGNOSTICMRUSECTION_HPP
+#define PLATFORMAGNOSTICMRUSECTION_HPP
+
+#include <QObject>
+#include <QPointer>
+#include <QList>
+#include <QString>
+#include <QVariant>
+
+#include <vector>
+
+class PlatformAgnosticMenu;
+class PlatformAgnosticAction;
+
+// A most recently used section, such as "Recent files", at the end of a menu.
+// It owns a fixed number of actions created up front. Updates rewrite the text
+// and the data of these actions instead of adding, removing or moving actions,
+// so they create nothing and cause at most one relayout of the native menu.
+// The actions survive PlatformAgnosticMenu::clear() and invalidateContent(),
+// and are added back to the end of the menu before it is shown again.
+class PlatformAgnosticMruSection : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Adds capacity hidden lazy actions to the end of menu
+    PlatformAgnosticMruSection(PlatformAgnosticMenu* menu, int capacity);
+
+    // Moves the entry with the same data, or the same text if data is not valid,
+    // to the top. A new entry replaces the oldest one once the section is full.
+    void touch(const QString& text, const QVariant& data = {});
+    bool remove(const QString& text, const QVariant& data = {});
+    void clear();
+
+    int count() const { return static_cast<int>(m_entries.size()); }
+    int capacity() const { return static_cast<int>(m_actions.size()); }
+    // From the most recent, 0, to the least recent, count() - 1
+    QString text(int index) const;
+    QVariant data(int index) const;
+
+signals:
+    void triggered(const QString& text, const QVariant& data);
+
+private:
+    struct Entry
+    {
+        QString text;
+        QVariant data;
+    };
+
+    int indexOf(const QString& text, const QVariant& data) const;
+    // Rewrites the actions that show the entries from first to last, excluded
+    void updateActions(int first, int last);
+    void onTriggered(PlatformAgnosticAction* action);
+    void onAboutToShow();
+
+    QPointer<PlatformAgnosticMenu> m_menu;
+    // The actions in the order of the menu, children of the section
+    QList<QPointer<PlatformAgnosticAction>> m_actions;
+
+    // From the most recent to the least recent
+    std::vector<Entry> m_entries;
+};
+
+#endif // PLATFORMAGNOSTICMRUSECTION_HPP
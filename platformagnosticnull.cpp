@@ -0,0 +1,491 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "platformagnosticnull.hpp"
+
+#include <QScopedValueRollback>
+
+#include <utility>
+
+#include "platformagnostictrace.hpp"
+
+PlatformAgnosticMenu* NullMenu::create(QObject *parent)
+{
+    if (!parent)
+        return new NullMenu;
+    else if (const auto nullMenuParent = qobject_cast<NullMenu*>(parent))
+        return new NullMenu(nullMenuParent);
+    else
+        return nullptr;
+}
+
+PlatformAgnosticAction* NullAction::create(QObject *parent, const bool lazy)
+{
+    if (!parent || qobject_cast<NullMenu*>(parent) || qobject_cast<NullActionGroup*>(parent))
+        return new NullAction(parent, lazy);
+    else
+        return nullptr;
+}
+
+PlatformAgnosticActionGroup* NullActionGroup::create(QObject *parent)
+{
+    if (!parent || qobject_cast<NullMenu*>(parent))
+        return new NullActionGroup(parent);
+    else
+        return nullptr;
+}
+
+NullMenu::NullMenu(NullMenu *parent)
+    : PlatformAgnosticMenu{parent}
+{
+}
+
+void NullMenu::insertAction(PlatformAgnosticAction *before, PlatformAgnosticAction *action)
+{
+    PLATFORMAGNOSTIC_TRACE(MenuInsertAction, this, before, action);
+
+    assert(qobject_cast<NullAction*>(action));
+
+    if (!before)
+    {
+        addAction(action);
+        return;
+    }
+
+    // Same steps as the other backends, without the native menu
+    materializePendingActions();
+    removePendingAction(action);
+    action->materialize();
+
+    {
+        const QScopedValueRollback<PlatformAgnosticAction*> moving{m_movingAction, action};
+        actionRemoved(action);
+    }
+    actionAdded(action, before);
+}
+
+void NullMenu::clear()
+{
+    PLATFORMAGNOSTIC_TRACE(MenuClear, this);
+
+    PlatformAgnosticMenu::clear();
+    clearPendingActions();
+
+    m_items.clear();
+    m_separatorCount = 0;
+}
+
+void NullMenu::addAction(PlatformAgnosticAction *action)
+{
+    PLATFORMAGNOSTIC_TRACE(MenuAddAction, this, action);
+
+    assert(qobject_cast<NullAction*>(action));
+
+    if (containsAction(action))
+    {
+        const QScopedValueRollback<PlatformAgnosticAction*> moving{m_movingAction, action};
+        removeAction(action);
+    }
+
+    actionAdded(action);
+
+    if (!deferAction(action))
+        addNativeAction(action);
+}
+
+void NullMenu::addNativeAction(PlatformAgnosticAction *action)
+{
+    Q_UNUSED(action);
+    assert(qobject_cast<NullAction*>(action));
+
+    // The index of the base class is the content of the menu
+}
+
+void NullMenu::removeAction(PlatformAgnosticAction *action)
+{
+    PLATFORMAGNOSTIC_TRACE(MenuRemoveAction, this, action);
+
+    assert(qobject_cast<NullAction*>(action));
+
+    actionRemoved(action);
+    removePendingAction(action);
+}
+
+void NullMenu::addMenu(PlatformAgnosticMenu *menu)
+{
+    PLATFORMAGNOSTIC_TRACE(MenuAddMenu, this, menu);
+
+    assert(qobject_cast<NullMenu*>(menu));
+
+    materializePendingActions();
+
+    // Like QMenu, the actions of submenus are reported by the parent menus too
+    connect(menu, &PlatformAgnosticMenu::triggered, this, &PlatformAgnosticMenu::triggered, Qt::UniqueConnection);
+
+    m_items.push_back(menu);
+}
+
+void NullMenu::popup(const QPoint &pos)
+{
+    PLATFORMAGNOSTIC_TRACE(MenuPopup, this, pos);
+
+    Q_UNUSED(pos);
+
+    if (m_open)
+        return;
+
+    m_open = true;
+    emit aboutToShow();
+}
+
+void NullMenu::close()
+{
+    PLATFORMAGNOSTIC_TRACE(MenuClose, this);
+
+    if (!m_open)
+        return;
+
+    m_open = false;
+    emit aboutToHide();
+}
+
+void NullMenu::addSeparator()
+{
+    PLATFORMAGNOSTIC_TRACE(MenuAddSeparator, this);
+
+    if (!deferSeparator())
+        addNativeSeparator();
+}
+
+void NullMenu::addNativeSeparator()
+{
+    ++m_separatorCount;
+}
+
+void NullMenu::addNativeItem(QObject *item)
+{
+    m_items.push_back(item);
+}
+
+QList<PlatformAgnosticMenu::PendingEntry> NullMenu::takeNativeContent()
+{
+    // The order of the separators is not kept, and the items stay
+    QList<PendingEntry> entries;
+
+    const auto actionList = actions();
+    for (const auto action : actionList)
+    {
+        // The lazy actions are pending already
+        if (!action->isLazy())
+            entries.push_back({action, false, {}});
+    }
+
+    for (; m_separatorCount > 0; --m_separatorCount)
+        entries.push_back({nullptr, true, {}});
+
+    return entries;
+}
+
+QSize NullMenu::sizeHint() const
+{
+    return {};
+}
+
+void NullMenu::setTearOffEnabled(bool enabled)
+{
+    Q_UNUSED(enabled);
+}
+
+void NullMenu::setFastPopup(bool enabled)
+{
+    // Nothing is shown, so there is nothing to lay out
+    m_fastPopup = enabled;
+}
+
+void NullMenu::addItem(QObject *item)
+{
+    assert(item);
+
+    materializePendingActions();
+    m_items.push_back(item);
+}
+
+void NullMenu::removeItem(QObject *item)
+{
+    m_items.removeOne(item);
+}
+
+void NullMenu::setTitle(const QString &title)
+{
+    PLATFORMAGNOSTIC_TRACE(MenuSetTitle, this, title);
+    m_title = title;
+}
+
+void NullMenu::setEnabled(const bool enabled)
+{
+    PLATFORMAGNOSTIC_TRACE(MenuSetEnabled, this, enabled);
+    m_enabled = enabled;
+}
+
+PlatformAgnosticAccounting::Usage NullMenu::usage() const
+{
+    auto usage = PlatformAgnosticMenu::usage();
+    usage.backend = static_cast<int>(Backend::Null);
+    usage.bytes += sizeof(NullMenu) - sizeof(PlatformAgnosticMenu)
+                   + m_items.capacity() * sizeof(QPointer<QObject>)
+                   + m_title.capacity() * sizeof(QChar);
+
+    // The separators are only counted, no object backs them
+    usage.separators = int(m_separatorCount);
+    return usage;
+}
+
+QObject* NullMenu::menu() const
+{
+    // There is no native menu, the wrapper stands in for it
+    return const_cast<NullMenu*>(this);
+}
+
+void NullMenu::setMenu(QObject *menu)
+{
+    // A null menu can only wrap itself
+    Q_UNUSED(menu);
+    assert(menu == this);
+}
+
+NullAction::NullAction(QObject *parent, const bool lazy)
+    : PlatformAgnosticAction{parent}
+{
+    if (lazy)
+        m_lazyState.reset(new LazyState{{}, {}, {}, {}, {}, true, false, false, true});
+    else
+        createNativeAction();
+}
+
+void NullAction::createNativeAction()
+{
+    assert(!m_materialized);
+
+    m_materialized = true;
+    m_ownsNativeAction = true;
+
+    m_nativeText.clear();
+    m_icon.clear();
+    m_shortcut = {};
+    m_enabled = true;
+    m_checkable = false;
+    m_checked = false;
+}
+
+void NullAction::destroyNativeAction(LazyState &state)
+{
+    assert(m_materialized);
+
+    state.icon = m_icon;
+    state.shortcut = m_shortcut;
+    m_materialized = false;
+}
+
+void NullAction::connectNativeSignals()
+{
+    // There is no native action to relay the signals from, they are emitted directly
+}
+
+void NullAction::setShortcut(const QKeySequence &shortcut)
+{
+    PLATFORMAGNOSTIC_TRACE(ActionSetShortcut, this, shortcut);
+
+    if (m_lazyState)
+    {
+        if (shortcut.isEmpty())
+        {
+            m_lazyState->shortcut = shortcut;
+            return;
+        }
+
+        // The shortcut has to work before the menu is first shown
+        materializeInMenus();
+    }
+
+    assert(m_materialized);
+    m_shortcut = shortcut;
+}
+
+void NullAction::setActionGroup(PlatformAgnosticActionGroup *actionGroup)
+{
+    PLATFORMAGNOSTIC_TRACE(ActionSetActionGroup, this, actionGroup);
+
+    assert(actionGroup ? !!qobject_cast<NullActionGroup*>(actionGroup) : true);
+
+    joinActionGroup(actionGroup);
+
+    if (m_lazyState)
+        m_lazyState->actionGroup = actionGroup;
+}
+
+void NullAction::setIcon(const QString &iconSourceOrName, const bool isSource)
+{
+    PLATFORMAGNOSTIC_TRACE(ActionSetIcon, this, iconSourceOrName, isSource);
+
+    if (m_lazyState)
+    {
+        m_lazyState->icon = iconSourceOrName;
+        m_lazyState->iconIsSource = isSource;
+        return;
+    }
+
+    assert(m_materialized);
+    m_icon = iconSourceOrName;
+}
+
+void NullAction::setChecked(const bool checked)
+{
+    PLATFORMAGNOSTIC_TRACE(ActionSetChecked, this, checked);
+
+    if (m_lazyState)
+    {
+        PlatformAgnosticAction::setChecked(checked);
+        return;
+    }
+
+    assert(m_materialized);
+
+    // Like QAction, only checkable actions can be checked
+    if (!m_checkable || m_checked == checked)
+        return;
+
+    PlatformAgnosticAction::setChecked(checked);
+
+    if (m_group)
+        static_cast<NullActionGroup*>(m_group)->onActionToggled(this, checked);
+
+    emit toggled(checked);
+}
+
+void NullAction::trigger()
+{
+    materialize();
+
+    if (!isEnabled())
+        return;
+
+    if (m_checkable)
+    {
+        // A checked action of an exclusive group stays checked
+        const bool exclusive = m_group && static_cast<NullActionGroup*>(m_group)->isExclusive();
+        if (!(exclusive && isChecked()))
+            setChecked(!isChecked());
+    }
+
+    emit triggered(isChecked());
+
+    if (m_group)
+        emit m_group->triggered(this);
+
+    for (const auto menu : std::as_const(m_menus))
+        emit menu->triggered(this);
+}
+
+PlatformAgnosticAccounting::Usage NullAction::usage() const
+{
+    auto usage = PlatformAgnosticAction::usage();
+    usage.backend = static_cast<int>(PlatformAgnosticMenu::Backend::Null);
+    usage.bytes += sizeof(NullAction) - sizeof(PlatformAgnosticAction)
+                   + (m_nativeText.capacity() + m_icon.capacity()) * sizeof(QChar);
+    return usage;
+}
+
+QObject *NullAction::action() const
+{
+    // There is no native action, the wrapper stands in for it once materialized
+    return m_materialized ? const_cast<NullAction*>(this) : nullptr;
+}
+
+void NullAction::setAction(QObject *action)
+{
+    // A null action can only wrap itself
+    Q_UNUSED(action);
+    assert(action == this);
+}
+
+NullActionGroup::NullActionGroup(QObject *parent)
+    : PlatformAgnosticActionGroup{parent}
+{
+}
+
+PlatformAgnosticAction* NullActionGroup::checkedAction() const
+{
+    // The checked action may have left the group since
+    if (m_checkedAction && m_checkedAction->m_group == this)
+        return m_checkedAction.data();
+
+    return nullptr;
+}
+
+void NullActionGroup::setEnabled(const bool enabled)
+{
+    PLATFORMAGNOSTIC_TRACE(ActionGroupSetEnabled, this, enabled);
+    m_enabled = enabled;
+}
+
+void NullActionGroup::setExclusive(const bool exclusive)
+{
+    PLATFORMAGNOSTIC_TRACE(ActionGroupSetExclusive, this, exclusive);
+    m_exclusive = exclusive;
+}
+
+void NullActionGroup::onActionToggled(NullAction *action, const bool checked)
+{
+    if (checked)
+    {
+        const auto previousAction = checkedAction();
+        m_checkedAction = action;
+
+        if (previousAction && previousAction != action && isExclusive())
+            previousAction->setChecked(false);
+    }
+    else if (m_checkedAction == action)
+    {
+        m_checkedAction = nullptr;
+    }
+}
+
+PlatformAgnosticAccounting::Usage NullActionGroup::usage() const
+{
+    auto usage = PlatformAgnosticActionGroup::usage();
+    usage.backend = static_cast<int>(PlatformAgnosticMenu::Backend::Null);
+    usage.bytes += sizeof(NullActionGroup) - sizeof(PlatformAgnosticActionGroup);
+    return usage;
+}
+
+QObject* NullActionGroup::actionGroup() const
+{
+    // There is no native group, the wrapper stands in for it
+    return const_cast<NullActionGroup*>(this);
+}
+
+void NullActionGroup::setActionGroup(QObject *actionGroup)
+{
+    // A null group can only wrap itself
+    Q_UNUSED(actionGroup);
+    assert(actionGroup == this);
+}
@@ -0,0 +1,189 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef PLATFORMAGNOSTICNULL_HPP
+#define PLATFORMAGNOSTICNULL_HPP
+
+#include <QPointer>
+
+#include "platformagnosticmenu.hpp"
+#include "platformagnosticaction.hpp"
+#include "platformagnosticactiongroup.hpp"
+
+class NullMenu final : public PlatformAgnosticMenu
+{
+    Q_OBJECT
+
+public:
+    explicit NullMenu(NullMenu* parent = nullptr);
+    virtual ~NullMenu() = default;
+
+    // Returns nullptr for a parent of another backend
+    static PlatformAgnosticMenu* create(QObject* parent);
+
+    void insertAction(PlatformAgnosticAction *before, PlatformAgnosticAction *action) override;
+
+    void clear() override;
+
+    void addAction(PlatformAgnosticAction *action) override;
+    void removeAction(PlatformAgnosticAction *action) override;
+
+    void addMenu(PlatformAgnosticMenu *menu) override;
+
+    void popup(const QPoint& pos) override;
+
+    void close() override;
+
+    void addSeparator() override;
+
+    QSize sizeHint() const override;
+
+    void setTearOffEnabled(bool enabled) override;
+    void setFastPopup(bool enabled) override;
+
+    void addItem(QObject* item) override;
+    void removeItem(QObject* item) override;
+
+    void setTitle(const QString& title) override;
+    void setEnabled(bool enabled) override;
+
+    PlatformAgnosticAccounting::Usage usage() const override;
+
+    QString title() const { return m_title; }
+    bool isEnabled() const { return m_enabled; }
+    bool isOpen() const { return m_open; }
+    bool isFastPopup() const { return m_fastPopup; }
+    // The pending separators are not counted
+    qsizetype separatorCount() const { return m_separatorCount; }
+    qsizetype itemCount() const { return m_items.size(); }
+
+protected:
+    QObject* menu() const override;
+    void setMenu(QObject * menu) override;
+    void addNativeAction(PlatformAgnosticAction* action) override;
+    void addNativeSeparator() override;
+    void addNativeItem(QObject* item) override;
+    QList<PendingEntry> takeNativeContent() override;
+    bool isNativeVisible() const override { return m_open; }
+
+private:
+    QList<QPointer<QObject>> m_items;
+    QString m_title;
+    qsizetype m_separatorCount = 0;
+    bool m_enabled = true;
+    bool m_open = false;
+    bool m_fastPopup = false;
+};
+
+class NullAction final : public PlatformAgnosticAction
+{
+    Q_OBJECT
+
+    friend class NullActionGroup;
+    friend class NullMenu;
+
+public:
+    explicit NullAction(QObject *parent = nullptr, bool lazy = false);
+    virtual ~NullAction() = default;
+
+    // Returns nullptr for a parent of another backend
+    static PlatformAgnosticAction* create(QObject* parent, bool lazy);
+
+    void setShortcut(const QKeySequence &shortcut) override;
+    void setActionGroup(PlatformAgnosticActionGroup* actionGroup) override;
+    void setIcon(const QString& iconSourceOrName, bool isSource = true) override;
+    void setChecked(bool checked) override;
+
+    PlatformAgnosticAccounting::Usage usage() const override;
+
+    QKeySequence shortcut() const { return m_shortcut; }
+    QString icon() const { return m_icon; }
+
+    // Does what a click on the action would do
+    void trigger();
+
+protected:
+    QObject* action() const override;
+    void setAction(QObject* action) override;
+    void createNativeAction() override;
+    void connectNativeSignals() override;
+    void destroyNativeAction(LazyState& state) override;
+
+    QString nativeText() const override { return m_nativeText; }
+    void setNativeText(const QString& text) override { m_nativeText = text; }
+    bool nativeEnabled() const override { return m_enabled; }
+    void setNativeEnabled(bool enabled) override { m_enabled = enabled; }
+    bool nativeCheckable() const override { return m_checkable; }
+    void setNativeCheckable(bool checkable) override { m_checkable = checkable; }
+    bool nativeChecked() const override { return m_checked; }
+    void setNativeChecked(bool checked) override { m_checked = checked; }
+    QKeySequence nativeShortcut() const override { return m_shortcut; }
+
+private:
+    // Whether action() returns the wrapper, unset while the action is lazy
+    bool m_materialized = false;
+
+    QString m_nativeText;
+    QString m_icon;
+    QKeySequence m_shortcut;
+    bool m_enabled = true;
+    bool m_checkable = false;
+    bool m_checked = false;
+};
+
+class NullActionGroup final : public PlatformAgnosticActionGroup
+{
+    Q_OBJECT
+
+    friend class NullAction;
+
+public:
+    explicit NullActionGroup(QObject* parent = nullptr);
+    virtual ~NullActionGroup() = default;
+
+    // Returns nullptr for a parent of another backend
+    static PlatformAgnosticActionGroup* create(QObject* parent);
+
+    PlatformAgnosticAction* checkedAction() const override;
+
+    void setEnabled(bool enabled) override;
+    void setExclusive(bool exclusive) override;
+
+    PlatformAgnosticAccounting::Usage usage() const override;
+
+    bool isEnabled() const { return m_enabled; }
+    bool isExclusive() const { return m_exclusive; }
+
+protected:
+    QObject* actionGroup() const override;
+    void setActionGroup(QObject* actionGroup) override;
+
+private:
+    // Called by NullAction::setChecked()
+    void onActionToggled(NullAction* action, bool checked);
+
+    QPointer<NullAction> m_checkedAction;
+    bool m_enabled = true;
+    bool m_exclusive = true;
+};
+
+#endif // PLATFORMAGNOSTICNULL_HPP
@@ -0,0 +1,896 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "platformagnosticquickcontrols2.hpp"
+
+#include <QQmlEngine>
+#include <QQmlProperty>
+#include <QQmlInfo>
+#include <QQmlListReference>
+#include <QQuickWindow>
+#include <QQuickItem>
+#include <QScopedValueRollback>
+
+#include <algorithm>
+
+#include "quickcontrols2cache.hpp"
+#include "quickcontrols2invoker.hpp"
+#include "platformagnostictrace.hpp"
+
+bool PlatformAgnosticBackend::registerQuickControls2()
+{
+    static const bool registered = [] {
+        PlatformAgnosticAccounting::registerQmlComponentCounter(&QuickControls2Cache::componentCount);
+        return registerFactory(Backend::QuickControls2, {&QuickControls2Menu::create, &QuickControls2Action::create, &QuickControls2ActionGroup::create});
+    }();
+    return registered;
+}
+
+PlatformAgnosticMenu* QuickControls2Menu::create(QObject *parent)
+{
+    // The Qt Quick objects need a parent to resolve their engine
+    if (const auto quickControls2MenuParent = qobject_cast<QuickControls2Menu*>(parent))
+        return new QuickControls2Menu(quickControls2MenuParent);
+    else if (const auto quickWindowParent = qobject_cast<QQuickWindow*>(parent))
+        return new QuickControls2Menu(quickWindowParent);
+    else if (const auto quickItemParent = qobject_cast<QQuickItem*>(parent))
+        return new QuickControls2Menu(quickItemParent);
+    else
+        return nullptr;
+}
+
+PlatformAgnosticAction* QuickControls2Action::create(QObject *parent, const bool lazy)
+{
+    if (const auto quickControls2MenuParent = qobject_cast<QuickControls2Menu*>(parent))
+        return new QuickControls2Action((*quickControls2MenuParent)(), quickControls2MenuParent, lazy);
+    else if (const auto quickControls2ActionGroupParent = qobject_cast<QuickControls2ActionGroup*>(parent))
+        return new QuickControls2Action((*quickControls2ActionGroupParent)(), quickControls2ActionGroupParent, lazy);
+    else if (const auto quickItemParent = qobject_cast<QQuickItem*>(parent))
+        return new QuickControls2Action(quickItemParent, quickItemParent, lazy);
+    else
+        return nullptr;
+}
+
+PlatformAgnosticActionGroup* QuickControls2ActionGroup::create(QObject *parent)
+{
+    if (const auto quickControls2MenuParent = qobject_cast<QuickControls2Menu*>(parent))
+        return new QuickControls2ActionGroup((*quickControls2MenuParent)(), quickControls2MenuParent);
+    else if (const auto quickItemParent = qobject_cast<QQuickItem*>(parent))
+        return new QuickControls2ActionGroup(quickItemParent, quickItemParent);
+    else
+        return nullptr;
+}
+
+QuickControls2Menu::QuickControls2Menu(QObject *quickParent, QObject* parent)
+    : PlatformAgnosticMenu{parent}
+{
+    assert(quickParent);
+
+    m_menu = QuickControls2Cache::create(quickParent, QuickControls2Cache::Component::Menu);
+    assert(m_menu->inherits("QQuickMenu"));
+
+    m_menu->setParent(this);
+
+    connect(m_menu, SIGNAL(aboutToShow()), this, SIGNAL(aboutToShow()));
+    connect(m_menu, SIGNAL(aboutToHide()), this, SIGNAL(aboutToHide()));
+
+    // Relayed by the delegate of MenuExt.qml. triggered() is relayed by the actions.
+    connect(m_menu, SIGNAL(_hovered(QObject*)), this, SLOT(onHovered(QObject*)));
+    connect(m_menu, SIGNAL(_subMenuHovered(QObject*)), this, SLOT(onSubMenuHovered(QObject*)));
+
+    if (const auto itemParent = qobject_cast<QQuickItem*>(quickParent))
+        m_menu->setProperty("parent", QVariant::fromValue(itemParent));
+
+    m_menu->setProperty("platformAgnosticMenu", QVariant::fromValue(this));
+}
+
+QuickControls2Menu::QuickControls2Menu(QuickControls2Menu *parent)
+    : QuickControls2Menu{parent->m_menu, parent}
+{
+
+}
+
+QuickControls2Menu::QuickControls2Menu(QQuickWindow *parent)
+    : QuickControls2Menu{parent->contentItem(), parent}
+{
+
+}
+
+QuickControls2Menu::QuickControls2Menu(QQuickItem *parent)
+    : QuickControls2Menu{parent, parent}
+{
+
+}
+
+QList<QObject *> QuickControls2Menu::eventTargets() const
+{
+    assert(m_menu);
+    QQuickItem* const contentItem = m_menu->property("contentItem").value<QQuickItem*>();
+    assert(contentItem);
+    return {m_menu.data(), contentItem};
+}
+
+void QuickControls2Menu::insertAction(PlatformAgnosticAction *before, PlatformAgnosticAction *action)
+{
+    PLATFORMAGNOSTIC_TRACE(MenuInsertAction, this, before, action);
+
+    if (!before)
+    {
+        addAction(action);
+        return;
+    }
+
+    assert(m_menu);
+    assert(action);
+    assert(qobject_cast<QuickControls2Action*>(action));
+
+    materializePendingActions();
+    removePendingAction(action);
+    action->materialize();
+
+    // Akin to QWidgets::insertAction()
+
+    if (containsAction(action))
+    {
+        const QScopedValueRollback<PlatformAgnosticAction*> moving{m_movingAction, action};
+        removeAction(action);
+    }
+
+    const int pos = containsAction(before) ? nativeIndexOf(before) : -1;
+    if (pos >= 0)
+    {
+        actionAdded(action, before);
+        static_cast<QuickControls2Action*>(action)->relayNativeSignals();
+        QuickControls2Invoker::insertAction(m_menu.data(), pos, static_cast<QuickControls2Action*>(action)->m_action.data());
+    }
+    else
+    {
+        addAction(action);
+    }
+}
+
+void QuickControls2Menu::clear()
+{
+    PLATFORMAGNOSTIC_TRACE(MenuClear, this);
+
+    assert(m_menu);
+
+    PlatformAgnosticMenu::clear();
+
+    if (m_separators.isEmpty())
+        return;
+
+    // The separators are taken out instead of destroyed, for the next addSeparator()
+    // calls. A menu that is rebuilt on every show creates its separators only once.
+    const auto contentData = QQmlListReference(m_menu.data(), "contentData");
+
+    for (auto i = contentData.count() - 1; i >= 0; --i)
+    {
+        QObject* const item = contentData.at(i);
+        if (!m_separators.contains(item))
+            continue;
+
+        QuickControls2Invoker::takeItem(m_menu.data(), i);
+        m_spareSeparators.push_back(item);
+    }
+
+    m_separators.clear();
+}
+
+void QuickControls2Menu::addAction(PlatformAgnosticAction *action)
+{
+    PLATFORMAGNOSTIC_TRACE(MenuAddAction, this, action);
+
+    assert(action);
+    assert(m_menu);
+    assert(qobject_cast<QuickControls2Action*>(action));
+
+    if (containsAction(action))
+    {
+        const QScopedValueRollback<PlatformAgnosticAction*> moving{m_movingAction, action};
+        removeAction(action);
+    }
+
+    actionAdded(action);
+    // Also for a lazy action, which connects once it is materialized
+    static_cast<QuickControls2Action*>(action)->relayNativeSignals();
+
+    if (!deferAction(action))
+        addNativeAction(action);
+}
+
+void QuickControls2Menu::addNativeAction(PlatformAgnosticAction *action)
+{
+    assert(m_menu);
+    assert(qobject_cast<QuickControls2Action*>(action));
+
+    QuickControls2Invoker::addAction(m_menu.data(), static_cast<QuickControls2Action*>(action)->m_action.data());
+}
+
+void QuickControls2Menu::removeAction(PlatformAgnosticAction *action)
+{
+    PLATFORMAGNOSTIC_TRACE(MenuRemoveAction, this, action);
+
+    assert(action);
+    assert(m_menu);
+    assert(qobject_cast<QuickControls2Action*>(action));
+
+    actionRemoved(action);
+
+    if (removePendingAction(action))
+        return;
+
+    QuickControls2Invoker::removeAction(m_menu.data(), static_cast<QuickControls2Action*>(action)->m_action.data());
+}
+
+void QuickControls2Menu::addMenu(PlatformAgnosticMenu *menu)
+{
+    PLATFORMAGNOSTIC_TRACE(MenuAddMenu, this, menu);
+
+    assert(m_menu);
+    assert(qobject_cast<QuickControls2Menu*>(menu));
+
+    materializePendingActions();
+
+    // Like QMenu, the actions of submenus are reported by the parent menus too
+    connect(menu, &PlatformAgnosticMenu::triggered, this, &PlatformAgnosticMenu::triggered, Qt::UniqueConnection);
+
+    QuickControls2Invoker::addMenu(m_menu.data(), static_cast<QuickControls2Menu*>(menu)->m_menu.data());
+}
+
+void QuickControls2Menu::popup(const QPoint &pos)
+{
+    PLATFORMAGNOSTIC_TRACE(MenuPopup, this, pos);
+
+    assert(m_menu);
+
+    materializePendingActions();
+
+    QPointF _pos = pos;
+
+    if (const auto parentItem = m_menu->property("parent").value<QQuickItem*>())
+    {
+        _pos = parentItem->mapFromGlobal(pos);
+    }
+
+    QuickControls2Invoker::setPosition(m_menu.data(), _pos);
+    QuickControls2Invoker::open(m_menu.data());
+}
+
+QList<PlatformAgnosticAction *> QuickControls2Menu::nativeActions() const
+{
+    QList<PlatformAgnosticAction*> list;
+
+    if (!m_menu)
+        return list;
+
+    assert(m_menu->inherits("QQuickMenu"));
+
+    const auto contentData = QQmlListReference(m_menu.data(), "contentData");
+
+    for (auto i = 0; i < contentData.count(); ++i)
+    {
+        const auto action = contentData.at(i)->property("action").value<QObject*>();
+        if (action)
+        {
+            assert(action->inherits("QQuickAction"));
+
+            if (const auto platformAgnosticAction = action->property("platformAgnosticAction").value<PlatformAgnosticAction*>())
+                list.push_back(platformAgnosticAction);
+        }
+    }
+
+    return list;
+}
+
+int QuickControls2Menu::nativeIndexOf(PlatformAgnosticAction *action) const
+{
+    assert(m_menu);
+    assert(qobject_cast<QuickControls2Action*>(action));
+
+    const QObject* const quickAction = static_cast<QuickControls2Action*>(action)->m_action.data();
+
+    // Separators and items take positions in the menu too
+    const auto contentData = QQmlListReference(m_menu.data(), "contentData");
+
+    for (auto i = 0; i < contentData.count(); ++i)
+    {
+        if (contentData.at(i)->property("action").value<QObject*>() == quickAction)
+            return i;
+    }
+
+    return -1;
+}
+
+void QuickControls2Menu::close()
+{
+    PLATFORMAGNOSTIC_TRACE(MenuClose, this);
+
+    assert(m_menu);
+    QMetaObject::invokeMethod(m_menu, "close");
+}
+
+void QuickControls2Menu::addSeparator()
+{
+    PLATFORMAGNOSTIC_TRACE(MenuAddSeparator, this);
+
+    if (!deferSeparator())
+        addNativeSeparator();
+}
+
+void QuickControls2Menu::addNativeSeparator()
+{
+    assert(m_menu);
+
+    QObject* separator = nullptr;
+    while (!separator && !m_spareSeparators.isEmpty())
+        separator = m_spareSeparators.takeLast();
+
+    if (!separator)
+    {
+        separator = QuickControls2Cache::create(m_menu, QuickControls2Cache::Component::MenuSeparator);
+        assert(qobject_cast<QQuickItem*>(separator));
+        assert(separator->inherits("QQuickMenuSeparator"));
+        separator->setParent(m_menu);
+    }
+
+    m_separators.push_back(separator);
+    QuickControls2Invoker::addItem(m_menu.data(), separator);
+}
+
+void QuickControls2Menu::addNativeItem(QObject *item)
+{
+    assert(m_menu);
+    assert(qobject_cast<QQuickItem*>(item));
+    QuickControls2Invoker::addItem(m_menu.data(), item);
+}
+
+QList<PlatformAgnosticMenu::PendingEntry> QuickControls2Menu::takeNativeContent()
+{
+    assert(m_menu);
+
+    QList<PendingEntry> entries;
+
+    const auto contentData = QQmlListReference(m_menu.data(), "contentData");
+    entries.reserve(contentData.count());
+
+    // Taken from the end, so that the indexes of the remaining items do not change
+    for (auto i = contentData.count() - 1; i >= 0; --i)
+    {
+        QObject* const item = QuickControls2Invoker::takeItem(m_menu.data(), i);
+        assert(item);
+
+        const auto action = item->property("action").value<QObject*>();
+
+        if (const auto platformAgnosticAction = action ? action->property("platformAgnosticAction").value<PlatformAgnosticAction*>() : nullptr)
+        {
+            // The delegate is created again by QQuickMenu::addAction()
+            entries.push_back({platformAgnosticAction, false, {}});
+            delete item;
+        }
+        else if (m_separators.contains(item))
+        {
+            entries.push_back({nullptr, true, {}});
+            delete item;
+        }
+        else
+        {
+            // Submenus and items are kept as they are
+            entries.push_back({nullptr, false, item});
+        }
+    }
+
+    std::reverse(entries.begin(), entries.end());
+
+    m_separators.clear();
+    for (const auto& separator : std::as_const(m_spareSeparators))
+        delete separator.data();
+    m_spareSeparators.clear();
+
+    return entries;
+}
+
+QSize QuickControls2Menu::sizeHint() const
+{
+    assert(m_menu);
+    // The size depends on the native actions
+    const_cast<QuickControls2Menu*>(this)->materializePendingActions();
+    polishContent();
+
+    return QSizeF{m_menu->property("implicitWidth").value<qreal>(),
+                  m_menu->property("implicitHeight").value<qreal>()}.toSize();
+}
+
+void QuickControls2Menu::polishContent() const
+{
+    assert(m_menu);
+
+    // We have to polish the item view otherwise implicit size is reported incorrectly.
+    // As an optimization, Qt does not calculate the item view content size until
+    // it becomes necessary.
+    if (const auto contentItem = m_menu->property("contentItem").value<QQuickItem*>())
+    {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 3, 0)
+        // Qt 6.3.0 has ensurePolished(), which calls updatePolish()
+        contentItem->ensurePolished();
+#else
+        // Before Qt 6.3.0, we can not use updatePolish() because it is protected.
+        // There are several alternatives, such as calling polish() and waiting
+        // until the window signals QQuickWindow::beforeSynchronizing.
+        // Another alternative is calling componentComplete(), which in turn
+        // calls updateViewport() that calculates the content size. Here,
+        // the invokable QQuickItemView::forceLayout() is used.
+        assert(contentItem->inherits("QQuickItemView"));
+        QMetaObject::invokeMethod(contentItem, "forceLayout");
+#endif
+    }
+}
+
+void QuickControls2Menu::setTearOffEnabled(bool enabled)
+{
+    // Stub
+    Q_UNUSED(enabled);
+    qmlDebug(m_menu.data()) << "Tear off is not supported by QuickControls2Menu!";
+}
+
+void QuickControls2Menu::setFastPopup(const bool enabled)
+{
+    assert(m_menu);
+
+    if (m_fastPopup == enabled)
+        return;
+
+    m_fastPopup = enabled;
+
+    if (enabled)
+    {
+        m_enterTransition = QQmlProperty::read(m_menu.data(), QStringLiteral("enter")).value<QObject*>();
+        m_exitTransition = QQmlProperty::read(m_menu.data(), QStringLiteral("exit")).value<QObject*>();
+        writeTransition(QStringLiteral("enter"), nullptr);
+        writeTransition(QStringLiteral("exit"), nullptr);
+
+        // The content is laid out again whenever it changes while hidden
+        connect(m_menu.data(), SIGNAL(countChanged()), this, SLOT(schedulePrelayout()));
+        schedulePrelayout();
+    }
+    else
+    {
+        disconnect(m_menu.data(), SIGNAL(countChanged()), this, SLOT(schedulePrelayout()));
+
+        writeTransition(QStringLiteral("enter"), m_enterTransition.data());
+        writeTransition(QStringLiteral("exit"), m_exitTransition.data());
+        m_enterTransition.clear();
+        m_exitTransition.clear();
+    }
+}
+
+void QuickControls2Menu::writeTransition(const QString &name, QObject* transition)
+{
+    // QObject::setProperty() can not convert a QObject* to the Transition*
+    // of the property in Qt 6, a null one included. QQmlProperty can, and an
+    // invalid QVariant clears the property.
+    const bool ret = QQmlProperty::write(m_menu.data(),
+                                         name,
+                                         transition ? QVariant::fromValue(transition) : QVariant());
+    assert(ret);
+}
+
+void QuickControls2Menu::schedulePrelayout()
+{
+    // Several changes in a row are laid out once
+    if (m_prelayoutPending)
+        return;
+
+    m_prelayoutPending = true;
+    QMetaObject::invokeMethod(this, &QuickControls2Menu::prelayout, Qt::QueuedConnection);
+}
+
+void QuickControls2Menu::prelayout()
+{
+    m_prelayoutPending = false;
+
+    if (!m_fastPopup || !m_menu || m_menu->property("visible").toBool() || isHibernated())
+        return;
+
+    // So that popup() only has to position the menu
+    materializePendingActions();
+    polishContent();
+}
+
+void QuickControls2Menu::addItem(QObject *item)
+{
+    assert(m_menu);
+    assert(qobject_cast<QQuickItem*>(item));
+
+    materializePendingActions();
+
+    QuickControls2Invoker::addItem(m_menu.data(), item);
+}
+
+void QuickControls2Menu::removeItem(QObject* item)
+{
+    assert(m_menu);
+    assert(qobject_cast<QQuickItem*>(item));
+
+    // Kept out of the menu by hibernate(), destroyed like QQuickMenu would
+    if (removePendingItem(item))
+    {
+        item->deleteLater();
+        return;
+    }
+
+    // Destroyed by QQuickMenu
+    m_separators.removeOne(item);
+
+    QuickControls2Invoker::removeItem(m_menu.data(), item);
+}
+
+PlatformAgnosticAccounting::Usage QuickControls2Menu::usage() const
+{
+    auto usage = PlatformAgnosticMenu::usage();
+    usage.backend = static_cast<int>(Backend::QuickControls2);
+    usage.bytes += sizeof(QuickControls2Menu) - sizeof(PlatformAgnosticMenu)
+                   + (m_separators.capacity() + m_spareSeparators.capacity()) * sizeof(QPointer<QObject>);
+
+    // The spare separators are kept until the menu is destroyed
+    const auto isAlive = [](const QPointer<QObject>& separator) { return !separator.isNull(); };
+    usage.separators = int(std::count_if(m_separators.cbegin(), m_separators.cend(), isAlive)
+                           + std::count_if(m_spareSeparators.cbegin(), m_spareSeparators.cend(), isAlive));
+    usage.nativeObjects = (m_menu ? 1 : 0) + usage.separators;
+    return usage;
+}
+
+QObject* QuickControls2Menu::menu() const
+{
+    return m_menu.data();
+}
+
+void QuickControls2Menu::setMenu(QObject *menu)
+{
+    assert(menu);
+    assert(menu->inherits("QQuickMenu"));
+
+    // The transitions of the previous menu are restored
+    const bool fastPopup = m_fastPopup;
+    if (fastPopup && m_menu)
+        setFastPopup(false);
+    m_fastPopup = false;
+
+    m_menu = menu;
+    updateEventTargets();
+
+    // The separators belong to the previous menu
+    m_separators.clear();
+    m_spareSeparators.clear();
+
+    // The menu may already have content when it is wrapped
+    clearPendingActions();
+    const auto actionList = nativeActions();
+    resetActions(actionList);
+    for (const auto action : actionList)
+        static_cast<QuickControls2Action*>(action)->relayNativeSignals();
+
+    setFastPopup(fastPopup);
+}
+
+void QuickControls2Menu::onHovered(QObject *action)
+{
+    if (!action)
+        return;
+
+    if (const auto platformAgnosticAction = action->property("platformAgnosticAction").value<PlatformAgnosticAction*>())
+        emit hovered(platformAgnosticAction);
+}
+
+void QuickControls2Menu::onSubMenuHovered(QObject *subMenu)
+{
+    if (!subMenu)
+        return;
+
+    if (const auto platformAgnosticMenu = subMenu->property("platformAgnosticMenu").value<PlatformAgnosticMenu*>())
+        submenuHovered(platformAgnosticMenu);
+}
+
+QuickControls2Action::QuickControls2Action(QObject *quickParent, QObject *parent, const bool lazy)
+    : PlatformAgnosticAction{parent}
+{
+    assert(quickParent);
+
+    if (lazy)
+        m_lazyState.reset(new LazyState{{}, {}, {}, quickParent, {}, true, false, false, true});
+    else
+        createQuickAction(quickParent);
+}
+
+void QuickControls2Action::createNativeAction()
+{
+    assert(m_lazyState);
+    createQuickAction(m_lazyState->quickParent);
+}
+
+void QuickControls2Action::createQuickAction(QObject *quickParent)
+{
+    assert(quickParent);
+    assert(!m_action);
+
+    m_action = QuickControls2Cache::create(quickParent, QuickControls2Cache::Component::Action);
+    assert(m_action->inherits("QQuickAction"));
+
+    m_action->setParent(this);
+    m_ownsNativeAction = true;
+
+    m_action->setProperty("platformAgnosticAction", QVariant::fromValue(this));
+}
+
+void QuickControls2Action::destroyNativeAction(LazyState &state)
+{
+    assert(m_action);
+    assert(m_menus.size() <= 1);
+
+    // setIcon() writes either the name or the source
+    const QString iconName = QQmlProperty::read(m_action.data(), QStringLiteral("icon.name"), qmlContext(m_action.data())).toString();
+    if (!iconName.isEmpty())
+    {
+        state.icon = iconName;
+        state.iconIsSource = false;
+    }
+    else
+    {
+        state.icon = QQmlProperty::read(m_action.data(), QStringLiteral("icon.source"), qmlContext(m_action.data())).toUrl().toString();
+    }
+
+    // The native menu resolves the engine when the action is created again
+    state.quickParent = m_menus.isEmpty() ? static_cast<QObject*>(this)
+                                          : static_cast<QuickControls2Menu*>(m_menus.first())->m_menu.data();
+
+    delete m_action.data();
+}
+
+QuickControls2Action::QuickControls2Action(QObject *parent)
+    : QuickControls2Action{parent, parent}
+{
+
+}
+
+void QuickControls2Action::connectNativeSignals()
+{
+    assert(m_action);
+
+    connect(m_action, SIGNAL(toggled(QObject*)), this, SLOT(onToggled(QObject*)), Qt::UniqueConnection);
+    connect(m_action, SIGNAL(triggered(QObject*)), this, SLOT(onTriggered(QObject*)), Qt::UniqueConnection);
+}
+
+void QuickControls2Action::setShortcut(const QKeySequence &shortcut)
+{
+    PLATFORMAGNOSTIC_TRACE(ActionSetShortcut, this, shortcut);
+
+    if (m_lazyState)
+    {
+        if (shortcut.isEmpty())
+        {
+            m_lazyState->shortcut = shortcut;
+            return;
+        }
+
+        // The shortcut has to work before the menu is first shown
+        materializeInMenus();
+    }
+
+    assert(m_action);
+
+    const bool ret = QQmlProperty::write(m_action.data(),
+                                         QStringLiteral("shortcut"),
+                                         shortcut);
+    assert(ret);
+}
+
+void QuickControls2Action::setActionGroup(PlatformAgnosticActionGroup *actionGroup)
+{
+    PLATFORMAGNOSTIC_TRACE(ActionSetActionGroup, this, actionGroup);
+
+    assert(actionGroup ? !!qobject_cast<QuickControls2ActionGroup*>(actionGroup) : true);
+
+    joinActionGroup(actionGroup);
+
+    if (m_lazyState)
+    {
+        m_lazyState->actionGroup = actionGroup;
+        return;
+    }
+
+    assert(m_action);
+
+    // m_actionGroup is the group the native action is in, which is
+    // not set yet when a lazy action is materialized
+    const auto quickControls2ActionGroup = static_cast<QuickControls2ActionGroup*>(actionGroup);
+    if (m_actionGroup == quickControls2ActionGroup)
+        return;
+
+    // Same as setting the attached ActionGroup.group property
+    if (m_actionGroup)
+        QuickControls2Invoker::removeGroupAction(m_actionGroup->m_actionGroup.data(), m_action.data());
+
+    m_actionGroup = quickControls2ActionGroup;
+
+    if (m_actionGroup)
+    {
+        QuickControls2Invoker::addGroupAction(m_actionGroup->m_actionGroup.data(), m_action.data());
+
+        // The triggered() signal of the group is relayed from onTriggered()
+        relayNativeSignals();
+    }
+}
+
+void QuickControls2Action::setIcon(const QString &_iconSourceOrName, const bool isSource)
+{
+    PLATFORMAGNOSTIC_TRACE(ActionSetIcon, this, _iconSourceOrName, isSource);
+
+    if (m_lazyState)
+    {
+        m_lazyState->icon = _iconSourceOrName;
+        m_lazyState->iconIsSource = isSource;
+        return;
+    }
+
+    assert(m_action);
+
+    QString iconSourceOrName = _iconSourceOrName;
+
+    const QLatin1String suffixSource{"source"};
+    const QLatin1String suffixName{"name"};
+    const QLatin1String *suffix;
+
+    if (isSource)
+    {
+        const auto qrc = QLatin1String{"qrc"};
+        if (!iconSourceOrName.startsWith(qrc))
+            iconSourceOrName.prepend(qrc);
+
+        suffix = &suffixSource;
+    }
+    else
+    {
+        suffix = &suffixName;
+    }
+
+    auto property = QQmlProperty(m_action.data(), "icon." + *suffix, qmlContext(m_action.data()));
+    assert(property.isValid() && property.isWritable());
+    const bool ret = property.write(iconSourceOrName);
+    assert(ret);
+}
+
+void QuickControls2Action::setFilteredOut(const bool filteredOut)
+{
+    m_filteredOut = filteredOut;
+    if (m_action)
+        m_action->setProperty("_filteredOut", filteredOut);
+}
+
+PlatformAgnosticAccounting::Usage QuickControls2Action::usage() const
+{
+    auto usage = PlatformAgnosticAction::usage();
+    usage.backend = static_cast<int>(PlatformAgnosticMenu::Backend::QuickControls2);
+    usage.bytes += sizeof(QuickControls2Action) - sizeof(PlatformAgnosticAction);
+    usage.nativeObjects = (m_ownsNativeAction && m_action) ? 1 : 0;
+    return usage;
+}
+
+QObject *QuickControls2Action::action() const
+{
+    return m_action.data();
+}
+
+void QuickControls2Action::setAction(QObject *action)
+{
+    assert(action);
+    assert(action->inherits("QQuickAction"));
+
+    // Replaces the native action or the lazy state the wrapper was created with
+    if (m_ownsNativeAction)
+        delete m_action.data();
+    m_lazyState.reset();
+
+    m_action = action;
+    m_ownsNativeAction = false;
+}
+
+void QuickControls2Action::onTriggered(QObject *source)
+{
+    Q_UNUSED(source);
+    emit triggered(m_action->property("checked").toBool());
+
+    // Relayed here rather than connecting to QQuickActionGroup::triggered(QQuickAction*),
+    // whose argument type is not available outside of the private API
+    if (m_actionGroup)
+        emit m_actionGroup->triggered(m_action.data());
+
+    // As QMenu does for its actions, so that shortcuts and trigger() reach the menus,
+    // not only the clicks on a MenuItem
+    for (const auto menu : std::as_const(m_menus))
+        emit menu->triggered(this);
+}
+
+void QuickControls2Action::onToggled(QObject *source)
+{
+    Q_UNUSED(source);
+    emit toggled(m_action->property("toggled").toBool());
+}
+
+PlatformAgnosticAccounting::Usage QuickControls2ActionGroup::usage() const
+{
+    auto usage = PlatformAgnosticActionGroup::usage();
+    usage.backend = static_cast<int>(PlatformAgnosticMenu::Backend::QuickControls2);
+    usage.bytes += sizeof(QuickControls2ActionGroup) - sizeof(PlatformAgnosticActionGroup);
+    usage.nativeObjects = (m_actionGroup && m_actionGroup->parent() == this) ? 1 : 0;
+    return usage;
+}
+
+QObject* QuickControls2ActionGroup::actionGroup() const
+{
+    return m_actionGroup.data();
+}
+
+void QuickControls2ActionGroup::setActionGroup(QObject *actionGroup)
+{
+    assert(actionGroup);
+    assert(actionGroup->inherits("QQuickActionGroup"));
+
+    // The group created by the constructor is replaced
+    if (m_actionGroup && m_actionGroup->parent() == this)
+        delete m_actionGroup.data();
+
+    m_actionGroup = actionGroup;
+}
+
+QuickControls2ActionGroup::QuickControls2ActionGroup(QObject *quickParent, QObject *parent)
+    : PlatformAgnosticActionGroup{parent}
+{
+    assert(quickParent);
+
+    m_actionGroup = QuickControls2Cache::create(quickParent, QuickControls2Cache::Component::ActionGroup);
+    assert(m_actionGroup->inherits("QQuickActionGroup"));
+
+    m_actionGroup->setParent(this);
+
+    connect(m_actionGroup, SIGNAL(checkedActionChanged()), this, SLOT(onCheckedActionChanged()));
+
+    m_actionGroup->setProperty("platformAgnosticActionGroup", QVariant::fromValue(this));
+}
+
+QuickControls2ActionGroup::QuickControls2ActionGroup(QObject *parent)
+    : QuickControls2ActionGroup{parent, parent}
+{
+
+}
+
+PlatformAgnosticAction* QuickControls2ActionGroup::checkedAction() const
+{
+    return m_checkedAction.data();
+}
+
+void QuickControls2ActionGroup::onCheckedActionChanged()
+{
+    assert(m_actionGroup);
+
+    const auto action = m_actionGroup->property("checkedAction").value<QObject*>();
+    m_checkedAction = action ? action->property("platformAgnosticAction").value<PlatformAgnosticAction*>() : nullptr;
+}
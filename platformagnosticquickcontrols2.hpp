@@ -0,0 +1,189 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef PLATFORMAGNOSTICQUICKCONTROLS2_HPP
+#define PLATFORMAGNOSTICQUICKCONTROLS2_HPP
+
+#include <QPointer>
+
+#include "platformagnosticmenu.hpp"
+#include "platformagnosticaction.hpp"
+#include "platformagnosticactiongroup.hpp"
+#include "platformagnosticbackend.hpp"
+
+class QuickControls2Menu final : public PlatformAgnosticMenu
+{
+    Q_OBJECT
+
+    friend class QuickControls2Action;
+    friend class QuickControls2ActionGroup;
+    friend struct QuickControls2Backend;
+
+public:
+    QuickControls2Menu(QObject* quickParent, class QObject* parent = nullptr);
+    virtual ~QuickControls2Menu() = default;
+
+    // Returns nullptr for a parent of another backend
+    static PlatformAgnosticMenu* create(QObject* parent);
+
+    explicit QuickControls2Menu(QuickControls2Menu *parent);
+    explicit QuickControls2Menu(class QQuickWindow* parent);
+    explicit QuickControls2Menu(class QQuickItem* parent);
+
+    void insertAction(PlatformAgnosticAction *before, PlatformAgnosticAction *action) override;
+
+    void clear() override;
+
+    void addAction(PlatformAgnosticAction *action) override;
+    void removeAction(PlatformAgnosticAction *action) override;
+
+    void addMenu(PlatformAgnosticMenu *menu) override;
+
+    void popup(const QPoint& pos) override;
+
+    void close() override;
+
+    void addSeparator() override;
+
+    QSize sizeHint() const override;
+
+    void setTearOffEnabled(bool enabled) override;
+    void setFastPopup(bool enabled) override;
+
+    void addItem(QObject* item) override;
+    void removeItem(QObject* item) override;
+
+    PlatformAgnosticAccounting::Usage usage() const override;
+
+protected:
+    QObject* menu() const override;
+    void setMenu(QObject * menu) override;
+    void addNativeAction(PlatformAgnosticAction* action) override;
+    void addNativeSeparator() override;
+    void addNativeItem(QObject* item) override;
+    QList<PendingEntry> takeNativeContent() override;
+    QList<QObject*> eventTargets() const override;
+
+private:
+    QList<PlatformAgnosticAction*> nativeActions() const;
+    int nativeIndexOf(PlatformAgnosticAction* action) const;
+    void polishContent() const;
+    void writeTransition(const QString& name, QObject* transition);
+
+    QPointer<QObject> m_menu;
+
+    // The separators in the menu, and the ones taken out by clear() to be reused
+    QList<QPointer<QObject>> m_separators;
+    QList<QPointer<QObject>> m_spareSeparators;
+
+    // The transitions of the style, restored when fast popup is turned off
+    QPointer<QObject> m_enterTransition;
+    QPointer<QObject> m_exitTransition;
+    bool m_fastPopup = false;
+    bool m_prelayoutPending = false;
+
+private slots:
+    void onHovered(QObject* action);
+    void onSubMenuHovered(QObject* subMenu);
+    void schedulePrelayout();
+    void prelayout();
+};
+
+class QuickControls2Action final : public PlatformAgnosticAction
+{
+    Q_OBJECT
+
+    friend class QuickControls2ActionGroup;
+    friend class QuickControls2Menu;
+
+public:
+    QuickControls2Action(QObject* quickParent, class QObject* parent = nullptr, bool lazy = false);
+
+    explicit QuickControls2Action(QObject *parent);
+    virtual ~QuickControls2Action() = default;
+
+    // Returns nullptr for a parent of another backend
+    static PlatformAgnosticAction* create(QObject* parent, bool lazy);
+
+    void setShortcut(const QKeySequence &shortcut) override;
+    void setActionGroup(PlatformAgnosticActionGroup* actionGroup) override;
+    void setIcon(const QString& iconSourceOrName, bool isSource = true) override;
+
+    PlatformAgnosticAccounting::Usage usage() const override;
+
+protected:
+    QObject* action() const override;
+    void setAction(QObject* action) override;
+    void createNativeAction() override;
+    void connectNativeSignals() override;
+    void destroyNativeAction(LazyState& state) override;
+    void setFilteredOut(bool filteredOut) override;
+
+private:
+    void createQuickAction(QObject* quickParent);
+
+    QPointer<QObject> m_action;
+    QPointer<class QuickControls2ActionGroup> m_actionGroup;
+
+private slots:
+    void onTriggered(QObject* source);
+    void onToggled(QObject* source);
+};
+
+class QuickControls2ActionGroup final : public PlatformAgnosticActionGroup
+{
+    Q_OBJECT
+
+    friend class QuickControls2Action;
+
+public:
+    QuickControls2ActionGroup(QObject* quickParent, class QObject* parent = nullptr);
+
+    explicit QuickControls2ActionGroup(QObject* parent);
+    virtual ~QuickControls2ActionGroup() = default;
+
+    // Returns nullptr for a parent of another backend
+    static PlatformAgnosticActionGroup* create(QObject* parent);
+
+    PlatformAgnosticAction* checkedAction() const override;
+
+    PlatformAgnosticAccounting::Usage usage() const override;
+
+protected:
+    QObject* actionGroup() const override;
+    void setActionGroup(QObject* actionGroup) override;
+
+private:
+    QPointer<QObject> m_actionGroup;
+    QPointer<PlatformAgnosticAction> m_checkedAction;
+
+private slots:
+    void onCheckedActionChanged();
+};
+
+namespace PlatformAgnosticBackend
+{
+    // Called during static initialization by platformagnosticquickcontrols2registration.cpp
+    bool registerQuickControls2();
+}
+
+#endif // PLATFORMAGNOSTICQUICKCONTROLS2_HPP
@@ -0,0 +1,129 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "platformagnosticspeculativebuilder.hpp"
+
+#include <QCoreApplication>
+#include <QTimer>
+#include <QPointer>
+#include <QDeadlineTimer>
+
+#include <cassert>
+
+#include "platformagnosticmenu.hpp"
+
+namespace
+{
+
+struct State
+{
+    QList<QPointer<PlatformAgnosticMenu>> queue;
+    std::chrono::milliseconds budget{4};
+    bool slicePending = false;
+};
+
+State& state()
+{
+    static State s;
+    return s;
+}
+
+void runSlice();
+
+// Posted to the application, so that nothing outlives it
+void scheduleSlice()
+{
+    auto& s = state();
+
+    if (s.slicePending)
+        return;
+
+    s.slicePending = true;
+    QTimer::singleShot(0, QCoreApplication::instance(), &runSlice);
+}
+
+void runSlice()
+{
+    auto& s = state();
+    s.slicePending = false;
+
+    const QDeadlineTimer deadline{s.budget, Qt::PreciseTimer};
+
+    while (!s.queue.isEmpty() && !deadline.hasExpired())
+    {
+        // The menu may be destroyed, or built by a show in the meantime
+        const QPointer<PlatformAgnosticMenu> menu = s.queue.first();
+        if (!menu || menu->buildContent(deadline))
+            s.queue.removeOne(menu);
+    }
+
+    // The next slice runs once the events that arrived meanwhile are processed
+    if (!s.queue.isEmpty())
+        scheduleSlice();
+}
+
+}
+
+void PlatformAgnosticSpeculativeBuilder::schedule(PlatformAgnosticMenu *menu, const bool urgent)
+{
+    assert(menu);
+
+    assert(QCoreApplication::instance());
+    assert(menu->thread() == QCoreApplication::instance()->thread());
+
+    auto& s = state();
+
+    const qsizetype index = s.queue.indexOf(menu);
+    if (index < 0)
+    {
+        if (urgent)
+            s.queue.prepend(menu);
+        else
+            s.queue.append(menu);
+    }
+    else if (urgent)
+    {
+        s.queue.move(index, 0);
+    }
+
+    scheduleSlice();
+}
+
+void PlatformAgnosticSpeculativeBuilder::cancel(PlatformAgnosticMenu *menu)
+{
+    state().queue.removeOne(menu);
+}
+
+bool PlatformAgnosticSpeculativeBuilder::isScheduled(const PlatformAgnosticMenu *menu)
+{
+    return state().queue.contains(const_cast<PlatformAgnosticMenu*>(menu));
+}
+
+void PlatformAgnosticSpeculativeBuilder::setSliceBudget(const std::chrono::milliseconds budget)
+{
+    state().budget = budget;
+}
+
+std::chrono::milliseconds PlatformAgnosticSpeculativeBuilder::sliceBudget()
+{
+    return state().budget;
+}
@@ -0,0 +1,45 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef PLATFORMAGNOSTICSPECULATIVEBUILDER_HPP
+#define PLATFORMAGNOSTICSPECULATIVEBUILDER_HPP
+
+#include <chrono>
+
+class PlatformAgnosticMenu;
+
+// Builds the menus that are likely to be shown next in idle time, through
+// PlatformAgnosticMenu::buildContent(). The work is done in slices that leave
+// most of a frame to rendering and input. Must be used on the main thread.
+namespace PlatformAgnosticSpeculativeBuilder
+{
+    // Queues the menu, in front of the others if urgent is set
+    void schedule(PlatformAgnosticMenu* menu, bool urgent = false);
+    void cancel(PlatformAgnosticMenu* menu);
+    bool isScheduled(const PlatformAgnosticMenu* menu);
+
+    // The time spent building per slice, 4 ms by default
+    void setSliceBudget(std::chrono::milliseconds budget);
+    std::chrono::milliseconds sliceBudget();
+}
+
+#endif // PLATFORMAGNOSTICSPECULATIVEBUILDER_HPP
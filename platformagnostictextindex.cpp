@@ -0,0 +1,135 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "platformagnostictextindex.hpp"
+
+#include <QSet>
+
+#include <cassert>
+#include <functional>
+#include <utility>
+
+QString PlatformAgnosticTextIndex::normalize(const QString &text)
+{
+    // Decompose, so that the diacritics can be dropped and "é" matches "e"
+    QString normalized = text.normalized(QString::NormalizationForm_KD).toCaseFolded();
+
+    // Mnemonics
+    normalized.remove(QLatin1Char('&'));
+
+    normalized.removeIf([](const QChar c) { return c.isMark(); });
+
+    return normalized;
+}
+
+void PlatformAgnosticTextIndex::insert(PlatformAgnosticAction *action, const QString &text)
+{
+    assert(action);
+
+    QString normalized = normalize(text);
+
+    const auto it = m_texts.find(action);
+    if (it != m_texts.end())
+    {
+        if (it.value() == normalized)
+            return;
+
+        removeEntries(action, it.value());
+        it.value() = std::move(normalized);
+        insertEntries(action, it.value());
+        return;
+    }
+
+    // The views stay valid when the hash grows, only the QString objects move
+    insertEntries(action, m_texts.insert(action, std::move(normalized)).value());
+}
+
+void PlatformAgnosticTextIndex::remove(PlatformAgnosticAction *action)
+{
+    const auto it = m_texts.find(action);
+    if (it == m_texts.end())
+        return;
+
+    removeEntries(action, it.value());
+    m_texts.erase(it);
+}
+
+void PlatformAgnosticTextIndex::clear()
+{
+    m_texts.clear();
+    m_prefixes.clear();
+    m_suffixes.clear();
+}
+
+QList<PlatformAgnosticAction *> PlatformAgnosticTextIndex::matchPrefix(const QString &text) const
+{
+    return match(m_prefixes, normalize(text));
+}
+
+QList<PlatformAgnosticAction *> PlatformAgnosticTextIndex::matchSubstring(const QString &text) const
+{
+    return match(m_suffixes, normalize(text));
+}
+
+bool PlatformAgnosticTextIndex::Less::operator()(const Suffix &a, const Suffix &b) const
+{
+    const int result = a.text.compare(b.text);
+    if (result != 0)
+        return result < 0;
+
+    return std::less<PlatformAgnosticAction*>()(a.action, b.action);
+}
+
+void PlatformAgnosticTextIndex::insertEntries(PlatformAgnosticAction *action, const QStringView text)
+{
+    m_prefixes.insert(Suffix{action, text});
+
+    for (qsizetype i = 0; i < text.size(); ++i)
+        m_suffixes.insert(Suffix{action, text.sliced(i)});
+}
+
+void PlatformAgnosticTextIndex::removeEntries(PlatformAgnosticAction *action, const QStringView text)
+{
+    m_prefixes.erase(Suffix{action, text});
+
+    for (qsizetype i = 0; i < text.size(); ++i)
+        m_suffixes.erase(Suffix{action, text.sliced(i)});
+}
+
+QList<PlatformAgnosticAction *> PlatformAgnosticTextIndex::match(const Table &table, const QString &text)
+{
+    QList<PlatformAgnosticAction *> list;
+
+    // An action may contain the text more than once
+    QSet<PlatformAgnosticAction*> found;
+
+    for (auto it = table.lower_bound(QStringView{text}); it != table.cend() && it->text.startsWith(text); ++it)
+    {
+        if (!found.contains(it->action))
+        {
+            found.insert(it->action);
+            list.push_back(it->action);
+        }
+    }
+
+    return list;
+}
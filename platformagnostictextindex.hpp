@@ -0,0 +1,85 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef PLATFORMAGNOSTICTEXTINDEX_HPP
+#define PLATFORMAGNOSTICTEXTINDEX_HPP
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringView>
+
+#include <set>
+
+class PlatformAgnosticAction;
+
+// Normalized, case folded text index of actions.
+// The prefix and suffix tables are kept sorted as actions are inserted and
+// removed, so a change only touches the entries of its action, and both
+// prefix and substring queries are a search followed by a walk over the matches.
+class PlatformAgnosticTextIndex
+{
+public:
+    static QString normalize(const QString& text);
+
+    // Replaces the text of the action if it is indexed already
+    void insert(PlatformAgnosticAction* action, const QString& text);
+    void remove(PlatformAgnosticAction* action);
+    void clear();
+
+    bool isEmpty() const { return m_texts.isEmpty(); }
+
+    // The results are not ordered
+    QList<PlatformAgnosticAction*> matchPrefix(const QString& text) const;
+    QList<PlatformAgnosticAction*> matchSubstring(const QString& text) const;
+
+private:
+    struct Suffix
+    {
+        PlatformAgnosticAction* action;
+        QStringView text;
+    };
+
+    // Orders by text, then by action. Compares with a bare text for the searches.
+    struct Less
+    {
+        using is_transparent = void;
+
+        bool operator()(const Suffix& a, const Suffix& b) const;
+        bool operator()(const Suffix& a, QStringView b) const { return a.text.compare(b) < 0; }
+        bool operator()(QStringView a, const Suffix& b) const { return a.compare(b.text) < 0; }
+    };
+
+    using Table = std::set<Suffix, Less>;
+
+    void insertEntries(PlatformAgnosticAction* action, QStringView text);
+    void removeEntries(PlatformAgnosticAction* action, QStringView text);
+    static QList<PlatformAgnosticAction*> match(const Table& table, const QString& text);
+
+    QHash<PlatformAgnosticAction*, QString> m_texts;
+
+    // Views into m_texts
+    Table m_prefixes;
+    Table m_suffixes;
+};
+
+#endif // PLATFORMAGNOSTICTEXTINDEX_HPP
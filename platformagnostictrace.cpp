@@ -0,0 +1,468 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "platformagnostictrace.hpp"
+
+#include <QIODevice>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QPoint>
+#include <QKeySequence>
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+#include "platformagnosticmenu.hpp"
+#include "platformagnosticaction.hpp"
+#include "platformagnosticactiongroup.hpp"
+
+std::atomic<bool> PlatformAgnosticTrace::s_recording{false};
+
+namespace
+{
+
+using PlatformAgnosticTrace::Op;
+
+constexpr char Magic[] = {'P', 'A', 'M', 'T'};
+constexpr quint8 Version = 1;
+
+// Flushed to the device once this size is reached
+constexpr qsizetype BufferSize = 64 * 1024;
+
+// The arguments that follow the object of each op: o object, s string, b bool,
+// i integer, p point, k key sequence
+constexpr const char* Signatures[] = {
+    "o", "ob", "o", "", "", "", "",
+    "oo", "o", "o", "o", "", "", "s", "b", "p", "", "si", "",
+    "s", "b", "b", "b", "b", "k", "sb", "o",
+    "o", "o", "", "b", "b", "i",
+};
+static_assert(std::size(Signatures) == size_t(Op::Count));
+
+constexpr const char* Names[] = {
+    "CreateMenu", "CreateAction", "CreateActionGroup",
+    "AdoptMenu", "AdoptAction", "AdoptActionGroup", "Destroy",
+    "MenuInsertAction", "MenuAddAction", "MenuRemoveAction", "MenuAddMenu", "MenuAddSeparator",
+    "MenuClear", "MenuSetTitle", "MenuSetEnabled", "MenuPopup", "MenuClose", "MenuSetFilter",
+    "MenuClearFilter",
+    "ActionSetText", "ActionSetVisible", "ActionSetEnabled", "ActionSetChecked",
+    "ActionSetCheckable", "ActionSetShortcut", "ActionSetIcon", "ActionSetActionGroup",
+    "ActionGroupAddAction", "ActionGroupRemoveAction", "ActionGroupClear",
+    "ActionGroupSetEnabled", "ActionGroupSetExclusive", "ActionGroupSetCheckedIndex",
+};
+static_assert(std::size(Names) == size_t(Op::Count));
+
+struct State
+{
+    QMutex mutex;
+    QIODevice* device = nullptr;
+    QByteArray buffer;
+    QElapsedTimer clock;
+    qint64 lastTimestamp = 0;
+    QHash<const QObject*, quint32> ids;
+    quint32 nextId = 1;
+};
+
+State& state()
+{
+    static State s;
+    return s;
+}
+
+// Only the outermost call of a thread is recorded
+thread_local int t_depth = 0;
+
+void writeVarint(QByteArray& out, quint64 value)
+{
+    while (value >= 0x80)
+    {
+        out.append(char(value | 0x80));
+        value >>= 7;
+    }
+    out.append(char(value));
+}
+
+void writeSigned(QByteArray& out, const qint64 value)
+{
+    writeVarint(out, (quint64(value) << 1) ^ quint64(value >> 63));
+}
+
+void writeString(QByteArray& out, const QString& string)
+{
+    const QByteArray utf8 = string.toUtf8();
+    writeVarint(out, quint64(utf8.size()));
+    out.append(utf8);
+}
+
+void flush(State& s)
+{
+    s.device->write(s.buffer);
+    s.buffer.clear();
+}
+
+void writeRecord(State& s, const Op op, const qint64 start, const qint64 duration,
+                 const quint32 object, const QByteArray& arguments)
+{
+    // Records are written when their call returns, in the order they were started
+    // on a single thread, so the delta is only negative for calls from several threads
+    s.buffer.append(char(op));
+    writeSigned(s.buffer, start - s.lastTimestamp);
+    writeVarint(s.buffer, quint64(duration));
+    writeVarint(s.buffer, object);
+    s.buffer.append(arguments);
+    s.lastTimestamp = start;
+
+    if (s.buffer.size() >= BufferSize)
+        flush(s);
+}
+
+// Called with the mutex held
+quint32 idOf(State& s, const QObject* object)
+{
+    if (!object)
+        return 0;
+
+    if (const auto it = s.ids.constFind(object); it != s.ids.cend())
+        return *it;
+
+    // Only the wrappers can be replayed, native objects are recorded as none
+    Op op;
+    if (qobject_cast<const PlatformAgnosticMenu*>(object))
+        op = Op::AdoptMenu;
+    else if (qobject_cast<const PlatformAgnosticAction*>(object))
+        op = Op::AdoptAction;
+    else if (qobject_cast<const PlatformAgnosticActionGroup*>(object))
+        op = Op::AdoptActionGroup;
+    else
+        return 0;
+
+    const quint32 id = s.nextId++;
+    s.ids.insert(object, id);
+    writeRecord(s, op, s.clock.nsecsElapsed(), 0, id, {});
+    return id;
+}
+
+bool readVarint(QIODevice* device, quint64& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        char byte;
+        if (!device->getChar(&byte))
+            return false;
+
+        value |= quint64(quint8(byte) & 0x7f) << shift;
+        if (!(quint8(byte) & 0x80))
+            return true;
+    }
+    return false;
+}
+
+bool readSigned(QIODevice* device, qint64& value)
+{
+    quint64 encoded;
+    if (!readVarint(device, encoded))
+        return false;
+
+    value = qint64(encoded >> 1) ^ -qint64(encoded & 1);
+    return true;
+}
+
+bool readString(QIODevice* device, QString& string)
+{
+    quint64 size;
+    if (!readVarint(device, size))
+        return false;
+
+    const QByteArray utf8 = device->read(qint64(size));
+    if (utf8.size() != qsizetype(size))
+        return false;
+
+    string = QString::fromUtf8(utf8);
+    return true;
+}
+
+}
+
+const char* PlatformAgnosticTrace::opName(const Op op)
+{
+    return op < Op::Count ? Names[size_t(op)] : "Unknown";
+}
+
+bool PlatformAgnosticTrace::start(QIODevice *device)
+{
+    assert(device);
+
+    auto& s = state();
+    const QMutexLocker locker(&s.mutex);
+
+    if (s.device || !device->isWritable())
+        return false;
+
+    s.device = device;
+    s.buffer.reserve(BufferSize);
+    s.buffer.append(Magic, sizeof(Magic));
+    s.buffer.append(char(Version));
+    s.lastTimestamp = 0;
+    s.ids.clear();
+    s.nextId = 1;
+    s.clock.start();
+
+    s_recording.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void PlatformAgnosticTrace::stop()
+{
+    auto& s = state();
+    const QMutexLocker locker(&s.mutex);
+
+    if (!s.device)
+        return;
+
+    s_recording.store(false, std::memory_order_relaxed);
+
+    flush(s);
+    s.device = nullptr;
+    s.ids.clear();
+    s.buffer.squeeze();
+}
+
+void PlatformAgnosticTrace::Scope::setResult(const QObject *object)
+{
+    // Only a recorded create gets a number. The objects created by a nested call
+    // are part of its replay, idOf() adopts them if they are used on their own.
+    if (m_op == Op::Count)
+        return;
+
+    // Nothing was created, so there is nothing to replay
+    if (!object)
+    {
+        m_op = Op::Count;
+        return;
+    }
+
+    auto& s = state();
+    const QMutexLocker locker(&s.mutex);
+
+    if (!s.device)
+        return;
+
+    m_object = s.nextId++;
+    s.ids.insert(object, m_object);
+}
+
+bool PlatformAgnosticTrace::Scope::begin(const Op op, const QObject *object)
+{
+    // Balanced by end() even when nothing is recorded
+    m_active = true;
+    m_op = Op::Count;
+
+    const bool nested = t_depth++ > 0;
+
+    auto& s = state();
+    const QMutexLocker locker(&s.mutex);
+
+    if (!s.device)
+        return false;
+
+    if (nested)
+    {
+        // The objects destroyed by a recorded call are destroyed by its replay,
+        // their addresses must not resolve to the old numbers
+        if (op == Op::Destroy)
+            s.ids.remove(object);
+        return false;
+    }
+
+    if (op == Op::Destroy)
+    {
+        // Objects that were never seen need no destroy, and addresses may be reused
+        m_object = s.ids.take(object);
+        if (!m_object)
+            return false;
+    }
+    else
+    {
+        m_object = idOf(s, object);
+    }
+
+    m_op = op;
+    m_start = s.clock.nsecsElapsed();
+    return true;
+}
+
+void PlatformAgnosticTrace::Scope::end()
+{
+    --t_depth;
+
+    if (m_op == Op::Count)
+        return;
+
+    auto& s = state();
+    const QMutexLocker locker(&s.mutex);
+
+    // Stopped meanwhile
+    if (!s.device)
+        return;
+
+    writeRecord(s, m_op, m_start, s.clock.nsecsElapsed() - m_start, m_object, m_arguments);
+}
+
+void PlatformAgnosticTrace::Scope::append(const QObject *object)
+{
+    auto& s = state();
+    const QMutexLocker locker(&s.mutex);
+
+    writeVarint(m_arguments, s.device ? idOf(s, object) : 0);
+}
+
+void PlatformAgnosticTrace::Scope::append(const QString &string)
+{
+    writeString(m_arguments, string);
+}
+
+void PlatformAgnosticTrace::Scope::append(const bool value)
+{
+    m_arguments.append(char(value));
+}
+
+void PlatformAgnosticTrace::Scope::append(const int value)
+{
+    writeSigned(m_arguments, value);
+}
+
+void PlatformAgnosticTrace::Scope::append(const qint64 value)
+{
+    writeSigned(m_arguments, value);
+}
+
+void PlatformAgnosticTrace::Scope::append(const QPoint &point)
+{
+    writeSigned(m_arguments, point.x());
+    writeSigned(m_arguments, point.y());
+}
+
+void PlatformAgnosticTrace::Scope::append(const QKeySequence &sequence)
+{
+    writeString(m_arguments, sequence.toString(QKeySequence::PortableText));
+}
+
+PlatformAgnosticTrace::Reader::Reader(QIODevice *device) :
+    m_device(device)
+{
+    assert(device);
+
+    char header[sizeof(Magic) + 1];
+    m_valid = device->read(header, sizeof(header)) == qint64(sizeof(header))
+              && std::equal(std::begin(Magic), std::end(Magic), header)
+              && quint8(header[sizeof(Magic)]) == Version;
+}
+
+bool PlatformAgnosticTrace::Reader::readNext(Record &record)
+{
+    if (!m_valid)
+        return false;
+
+    char op;
+    if (!m_device->getChar(&op))
+        return false;
+
+    if (quint8(op) >= quint8(Op::Count))
+    {
+        m_valid = false;
+        return false;
+    }
+
+    record.op = Op(op);
+    record.arguments.clear();
+
+    qint64 delta;
+    quint64 duration;
+    quint64 object;
+    if (!readSigned(m_device, delta) || !readVarint(m_device, duration) || !readVarint(m_device, object))
+    {
+        m_valid = false;
+        return false;
+    }
+
+    m_timestamp += delta;
+    record.timestamp = m_timestamp;
+    record.duration = qint64(duration);
+    record.object = quint32(object);
+
+    for (const char* type = Signatures[size_t(record.op)]; *type; ++type)
+    {
+        bool ok = true;
+        switch (*type)
+        {
+        case 'o':
+        {
+            quint64 id;
+            ok = readVarint(m_device, id);
+            record.arguments.append(quint32(id));
+            break;
+        }
+        case 's':
+        case 'k':
+        {
+            QString string;
+            ok = readString(m_device, string);
+            record.arguments.append(string);
+            break;
+        }
+        case 'b':
+        {
+            char value;
+            ok = m_device->getChar(&value);
+            record.arguments.append(value != 0);
+            break;
+        }
+        case 'i':
+        {
+            qint64 value;
+            ok = readSigned(m_device, value);
+            record.arguments.append(value);
+            break;
+        }
+        case 'p':
+        {
+            qint64 x, y;
+            ok = readSigned(m_device, x) && readSigned(m_device, y);
+            record.arguments.append(QPoint(int(x), int(y)));
+            break;
+        }
+        default:
+            Q_UNREACHABLE();
+        }
+
+        if (!ok)
+        {
+            m_valid = false;
+            return false;
+        }
+    }
+
+    return true;
+}
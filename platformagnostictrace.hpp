@@ -0,0 +1,176 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef PLATFORMAGNOSTICTRACE_HPP
+#define PLATFORMAGNOSTICTRACE_HPP
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QString>
+#include <QVariant>
+#include <QList>
+
+#include <atomic>
+
+class QObject;
+class QIODevice;
+class QPoint;
+class QKeySequence;
+
+// Records the public calls on the menus, actions and action groups, with their
+// timing, in a compact binary log. The replay tool of the benchmarks runs a log
+// against any backend. Recording is off by default, and then costs an atomic load.
+namespace PlatformAgnosticTrace
+{
+    enum class Op : quint8
+    {
+        // The object of a create record is the created object
+        CreateMenu,
+        CreateAction,
+        CreateActionGroup,
+        // Objects that existed before recording started, or were wrapped by fromMenu() etc.
+        AdoptMenu,
+        AdoptAction,
+        AdoptActionGroup,
+        Destroy,
+
+        MenuInsertAction,
+        MenuAddAction,
+        MenuRemoveAction,
+        MenuAddMenu,
+        MenuAddSeparator,
+        MenuClear,
+        MenuSetTitle,
+        MenuSetEnabled,
+        MenuPopup,
+        MenuClose,
+        MenuSetFilter,
+        MenuClearFilter,
+
+        ActionSetText,
+        ActionSetVisible,
+        ActionSetEnabled,
+        ActionSetChecked,
+        ActionSetCheckable,
+        ActionSetShortcut,
+        ActionSetIcon,
+        ActionSetActionGroup,
+
+        ActionGroupAddAction,
+        ActionGroupRemoveAction,
+        ActionGroupClear,
+        ActionGroupSetEnabled,
+        ActionGroupSetExclusive,
+        ActionGroupSetCheckedIndex,
+
+        Count
+    };
+
+    const char* opName(Op op);
+
+    // The device must stay open until stop(). Returns false if it is not writable
+    // or a recording is already running.
+    bool start(QIODevice* device);
+    void stop();
+
+    extern std::atomic<bool> s_recording;
+    inline bool isRecording() { return s_recording.load(std::memory_order_relaxed); }
+
+    // Records the outermost call of the current thread when it returns, together
+    // with its duration. The calls it makes are part of it, and are not recorded.
+    class Scope
+    {
+    public:
+        template<typename... Args>
+        Scope(const Op op, const QObject* const object, const Args&... args)
+        {
+            if (Q_LIKELY(!isRecording()))
+                return;
+
+            if (begin(op, object))
+                (append(args), ...);
+        }
+
+        ~Scope()
+        {
+            if (Q_UNLIKELY(m_active))
+                end();
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        // Sets the object that a create call returns, ignored unless the call is recorded
+        void setResult(const QObject* object);
+
+    private:
+        bool begin(Op op, const QObject* object);
+        void end();
+
+        void append(const QObject* object);
+        void append(const QString& string);
+        void append(bool value);
+        void append(int value);
+        void append(qint64 value);
+        void append(const QPoint& point);
+        void append(const QKeySequence& sequence);
+
+        bool m_active = false;
+        Op m_op = Op::Count;
+        quint32 m_object = 0;
+        qint64 m_start = 0;
+        QByteArray m_arguments;
+    };
+
+    struct Record
+    {
+        Op op = Op::Count;
+        // In nanoseconds since the recording started
+        qint64 timestamp = 0;
+        qint64 duration = 0;
+        // Objects are numbered from 1, 0 is none
+        quint32 object = 0;
+        // Object numbers are quint32, key sequences are in their portable text form
+        QVariantList arguments;
+    };
+
+    class Reader
+    {
+    public:
+        explicit Reader(QIODevice* device);
+
+        bool isValid() const { return m_valid; }
+        // Returns false at the end of the log, or if it is truncated
+        bool readNext(Record& record);
+
+    private:
+        QIODevice* m_device;
+        bool m_valid = false;
+        qint64 m_timestamp = 0;
+    };
+}
+
+// Records the enclosing call as op on object, with the arguments that follow
+#define PLATFORMAGNOSTIC_TRACE(op, ...) \
+    const PlatformAgnosticTrace::Scope platformAgnosticTraceScope{PlatformAgnosticTrace::Op::op, __VA_ARGS__}
+
+#endif // PLATFORMAGNOSTICTRACE_HPP
@@ -0,0 +1,1137 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "platformagnosticwidgets.hpp"
+
+#include <QMenu>
+#include <QAction>
+#include <QActionGroup>
+#include <QWidgetAction>
+#include <QActionEvent>
+#include <QCoreApplication>
+#include <QScopedValueRollback>
+#include <QIcon>
+#include <QToolButton>
+
+#include <algorithm>
+#include <utility>
+
+#include "platformagnostictrace.hpp"
+
+namespace
+{
+
+// Swallows the ActionChanged events sent to a menu, remembering the last action
+class ActionChangedBlocker : public QObject
+{
+public:
+    QAction* lastAction() const { return m_lastAction.data(); }
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        Q_UNUSED(watched);
+
+        if (event->type() != QEvent::ActionChanged)
+            return false;
+
+        m_lastAction = static_cast<QActionEvent*>(event)->action();
+        return true;
+    }
+
+private:
+    QPointer<QAction> m_lastAction;
+};
+
+}
+
+bool PlatformAgnosticBackend::registerWidgets()
+{
+    static const bool registered = registerFactory(Backend::Widgets, {&WidgetsMenu::create, &WidgetsAction::create, &WidgetsActionGroup::create});
+    return registered;
+}
+
+template<>
+PlatformAgnosticMenu* PlatformAgnosticMenu::fromMenu(QMenu * menu)
+{
+    assert(menu);
+
+    PlatformAgnosticMenu* const widgetsMenu = new WidgetsMenu;
+
+    widgetsMenu->setMenu(menu);
+    // Destroyed with the menu, unless it is destroyed first and takes the menu along
+    widgetsMenu->setParent(menu);
+
+    connect(menu, &QMenu::aboutToHide, widgetsMenu, &PlatformAgnosticMenu::aboutToHide);
+    connect(menu, &QMenu::aboutToShow, widgetsMenu, &PlatformAgnosticMenu::aboutToShow);
+
+    menu->setProperty("platformAgnosticMenu", QVariant::fromValue(widgetsMenu));
+
+    return widgetsMenu;
+}
+
+template<>
+PlatformAgnosticAction* PlatformAgnosticAction::fromAction(QAction *action)
+{
+    assert(action);
+
+    // Lazy, so that no native action is created only to be replaced.
+    // Destroyed with the action, which it does not own.
+    PlatformAgnosticAction* const widgetsAction = new WidgetsAction(action, true);
+
+    widgetsAction->setAction(action);
+
+    connect(action, &QAction::toggled, widgetsAction, &PlatformAgnosticAction::toggled);
+    connect(action, &QAction::triggered, widgetsAction, &PlatformAgnosticAction::triggered);
+
+    action->setProperty("platformAgnosticAction", QVariant::fromValue(widgetsAction));
+
+    return widgetsAction;
+}
+
+template<>
+PlatformAgnosticActionGroup* PlatformAgnosticActionGroup::fromActionGroup(QActionGroup * actionGroup)
+{
+    assert(actionGroup);
+
+    // Destroyed with the action group, which it does not own
+    PlatformAgnosticActionGroup* const widgetsActionGroup = new WidgetsActionGroup(actionGroup);
+
+    widgetsActionGroup->setActionGroup(actionGroup);
+
+    connect(actionGroup, &QActionGroup::triggered, widgetsActionGroup, &PlatformAgnosticActionGroup::triggered);
+    actionGroup->setProperty("platformAgnosticActionGroup", QVariant::fromValue(widgetsActionGroup));
+
+    return widgetsActionGroup;
+}
+
+PlatformAgnosticMenu* WidgetsMenu::create(QObject *parent)
+{
+    if (!parent)
+        return new WidgetsMenu;
+    else if (const auto widgetsMenuParent = qobject_cast<WidgetsMenu*>(parent))
+        return new WidgetsMenu(widgetsMenuParent);
+    else
+        return nullptr;
+}
+
+PlatformAgnosticAction* WidgetsAction::create(QObject *parent, const bool lazy)
+{
+    if (!parent || qobject_cast<WidgetsMenu*>(parent) || qobject_cast<WidgetsActionGroup*>(parent))
+        return new WidgetsAction(parent, lazy);
+    else
+        return nullptr;
+}
+
+PlatformAgnosticActionGroup* WidgetsActionGroup::create(QObject *parent)
+{
+    if (!parent || qobject_cast<WidgetsMenu*>(parent))
+        return new WidgetsActionGroup(parent);
+    else
+        return nullptr;
+}
+
+WidgetsMenu::WidgetsMenu(WidgetsMenu* parent)
+    : PlatformAgnosticMenu{parent}
+{
+    m_menu = new QMenu(parent ? parent->m_menu : nullptr);
+    connect(m_menu.data(), &QMenu::aboutToHide, this, &PlatformAgnosticMenu::aboutToHide);
+    connect(m_menu.data(), &QMenu::aboutToShow, this, &PlatformAgnosticMenu::aboutToShow);
+    connectMenu();
+
+    // After the pending actions are materialized, and before QMenu lays out the page
+    connect(this, &PlatformAgnosticMenu::aboutToShow, this, &WidgetsMenu::updatePage);
+    // Every popup starts on the first page
+    connect(this, &PlatformAgnosticMenu::aboutToHide, this, [this]() { m_pageStart = 0; });
+
+    //static_cast<QObject*>(m_menu)->setParent(this); // Qt bug
+
+    m_menu->setProperty("platformAgnosticMenu", QVariant::fromValue(this));
+}
+
+void WidgetsMenu::connectMenu()
+{
+    assert(m_menu);
+
+    // QMenu already emits triggered() for the actions of its submenus
+    connect(m_menu.data(), &QMenu::triggered, this, [this](QAction* action) {
+        if (const auto platformAgnosticAction = action->property("platformAgnosticAction").value<PlatformAgnosticAction*>())
+            emit triggered(platformAgnosticAction);
+    });
+
+    connect(m_menu.data(), &QMenu::hovered, this, [this](QAction* action) {
+        if (const auto platformAgnosticAction = action->property("platformAgnosticAction").value<PlatformAgnosticAction*>())
+            emit hovered(platformAgnosticAction);
+        else if (const auto subMenu = action->menu())
+        {
+            // QMenu opens the submenu after a delay, which is used to build it
+            if (const auto platformAgnosticMenu = subMenu->property("platformAgnosticMenu").value<PlatformAgnosticMenu*>())
+                submenuHovered(platformAgnosticMenu);
+        }
+    });
+}
+
+WidgetsMenu::~WidgetsMenu()
+{
+    // Since we can not set QObject::parent on m_menu
+    // we should delete it here. It is already gone when
+    // the wrapper of fromMenu() is destroyed as its child.
+    if (m_menu)
+        m_menu->deleteLater();
+
+    for (auto it = m_shortcutWindows.cbegin(); it != m_shortcutWindows.cend(); ++it)
+    {
+        if (it.value())
+            it.value()->removeAction(it.key());
+    }
+}
+
+void WidgetsMenu::insertAction(PlatformAgnosticAction *before, PlatformAgnosticAction *action)
+{
+    PLATFORMAGNOSTIC_TRACE(MenuInsertAction, this, before, action);
+
+    assert(m_menu);
+    assert(qobject_cast<WidgetsAction*>(action));
+
+    if (before)
+    {
+        assert(qobject_cast<WidgetsAction*>(before));
+
+        materializePendingActions();
+        removePendingAction(action);
+        action->materialize();
+        before->materialize();
+
+        // QMenu::insertAction() moves an action that is already in the menu
+        {
+            const QScopedValueRollback<PlatformAgnosticAction*> moving{m_movingAction, action};
+            actionRemoved(action);
+        }
+        actionAdded(action, before);
+        insertNative(static_cast<WidgetsAction*>(before)->m_action, static_cast<WidgetsAction*>(action)->m_action);
+    }
+    else
+    {
+        addAction(action);
+    }
+}
+
+void WidgetsMenu::clear()
+{
+    PLATFORMAGNOSTIC_TRACE(MenuClear, this);
+
+    assert(m_menu);
+
+    const auto actionList = actions();
+    for (const auto action : actionList)
+        actionRemoved(action);
+
+    clearPendingActions();
+    clearNative();
+}
+
+void WidgetsMenu::addAction(PlatformAgnosticAction *action)
+{
+    PLATFORMAGNOSTIC_TRACE(MenuAddAction, this, action);
+
+    assert(qobject_cast<WidgetsAction*>(action));
+    assert(m_menu);
+
+    if (containsAction(action))
+    {
+        const QScopedValueRollback<PlatformAgnosticAction*> moving{m_movingAction, action};
+        removeAction(action);
+    }
+
+    actionAdded(action);
+
+    if (!deferAction(action))
+        addNativeAction(action);
+}
+
+void WidgetsMenu::addNativeAction(PlatformAgnosticAction *action)
+{
+    assert(qobject_cast<WidgetsAction*>(action));
+    assert(m_menu);
+
+    addNative(static_cast<WidgetsAction*>(action)->m_action);
+}
+
+void WidgetsMenu::applyFilter(const QList<PlatformAgnosticAction *> &filteredOut,
+                              const QList<PlatformAgnosticAction *> &filteredIn)
+{
+    batchUpdates([&]() {
+        PlatformAgnosticMenu::applyFilter(filteredOut, filteredIn);
+    });
+
+    // The matches are paged from the first one
+    if (pageSize() > 0)
+    {
+        m_pageStart = 0;
+        updatePage();
+    }
+}
+
+void WidgetsMenu::batchUpdates(const std::function<void ()> &updates)
+{
+    assert(m_menu);
+
+    if (!m_menu->isVisible())
+    {
+        // A hidden QMenu only marks its items dirty
+        updates();
+        return;
+    }
+
+    // A visible QMenu lays itself out again for every changed action,
+    // so hold the events back and lay out once at the end
+    ActionChangedBlocker blocker;
+    m_menu->installEventFilter(&blocker);
+    updates();
+    m_menu->removeEventFilter(&blocker);
+
+    if (blocker.lastAction())
+    {
+        QActionEvent event(QEvent::ActionChanged, blocker.lastAction());
+        QCoreApplication::sendEvent(m_menu.data(), &event);
+    }
+}
+
+void WidgetsMenu::removeAction(PlatformAgnosticAction *action)
+{
+    PLATFORMAGNOSTIC_TRACE(MenuRemoveAction, this, action);
+
+    assert(qobject_cast<WidgetsAction*>(action));
+    assert(m_menu);
+
+    actionRemoved(action);
+
+    if (removePendingAction(action))
+        return;
+
+    removeNative(static_cast<WidgetsAction*>(action)->m_action);
+}
+
+void WidgetsMenu::addMenu(PlatformAgnosticMenu *menu)
+{
+    PLATFORMAGNOSTIC_TRACE(MenuAddMenu, this, menu);
+
+    assert(qobject_cast<WidgetsMenu*>(menu));
+    assert(m_menu);
+
+    materializePendingActions();
+    addNative(static_cast<WidgetsMenu*>(menu)->m_menu->menuAction());
+}
+
+void WidgetsMenu::popup(const QPoint &pos)
+{
+    PLATFORMAGNOSTIC_TRACE(MenuPopup, this, pos);
+
+    assert(m_menu);
+    materializePendingActions();
+    m_menu->popup(pos);
+}
+
+QList<PlatformAgnosticAction *> WidgetsMenu::nativeActions() const
+{
+    assert(m_menu);
+
+    QList<PlatformAgnosticAction *> list;
+
+    const auto actions = nativeContent();
+
+    for (const auto i : actions)
+    {
+        if (const auto PlatformagnosticAction = i->property("platformAgnosticAction").value<PlatformAgnosticAction*>())
+            list.push_back(PlatformagnosticAction);
+    }
+
+    return list;
+}
+
+void WidgetsMenu::close()
+{
+    PLATFORMAGNOSTIC_TRACE(MenuClose, this);
+
+    assert(m_menu);
+
+    m_menu->close();
+}
+
+void WidgetsMenu::addSeparator()
+{
+    PLATFORMAGNOSTIC_TRACE(MenuAddSeparator, this);
+
+    if (!deferSeparator())
+        addNativeSeparator();
+}
+
+void WidgetsMenu::addNativeSeparator()
+{
+    assert(m_menu);
+
+    // Owned by the menu, as the separators of QMenu::addSeparator()
+    const auto separator = new QAction(m_menu);
+    separator->setSeparator(true);
+    m_separators.push_back(separator);
+    addNative(separator);
+}
+
+void WidgetsMenu::addNativeItem(QObject *item)
+{
+    assert(m_menu);
+    assert(qobject_cast<QAction*>(item));
+    addNative(static_cast<QAction*>(item));
+}
+
+QList<PlatformAgnosticMenu::PendingEntry> WidgetsMenu::takeNativeContent()
+{
+    assert(m_menu);
+
+    QList<PendingEntry> entries;
+
+    const auto nativeList = nativeContent();
+    entries.reserve(nativeList.size());
+
+    // Submenus and items are kept as they are. The actions are removed one by one, as
+    // QMenu::clear() would also delete the items owned by the menu, such as QWidgetActions.
+    for (const auto action : nativeList)
+    {
+        removeNative(action);
+
+        if (const auto platformAgnosticAction = action->property("platformAgnosticAction").value<PlatformAgnosticAction*>())
+        {
+            entries.push_back({platformAgnosticAction, false, {}});
+        }
+        else if (m_separators.contains(action))
+        {
+            entries.push_back({nullptr, true, {}});
+            delete action;
+        }
+        else
+        {
+            entries.push_back({nullptr, false, action});
+        }
+    }
+
+    m_separators.clear();
+    m_pageStart = 0;
+
+    return entries;
+}
+
+QSize WidgetsMenu::sizeHint() const
+{
+    assert(m_menu);
+    // The size depends on the native actions
+    const_cast<WidgetsMenu*>(this)->materializePendingActions();
+    const_cast<WidgetsMenu*>(this)->updatePage();
+    return m_menu->sizeHint();
+}
+
+void WidgetsMenu::setTearOffEnabled(bool enabled)
+{
+    assert(m_menu);
+    m_menu->setTearOffEnabled(enabled);
+}
+
+void WidgetsMenu::setFastPopup(const bool enabled)
+{
+    assert(m_menu);
+
+    if (m_fastPopup == enabled)
+        return;
+
+    m_fastPopup = enabled;
+
+    // The show animation of QMenu is the application wide Qt::UI_AnimateMenu effect,
+    // so only the layout is done ahead of time
+    if (enabled)
+    {
+        m_menu->installEventFilter(this);
+        schedulePrelayout();
+    }
+    else
+    {
+        m_menu->removeEventFilter(this);
+    }
+}
+
+bool WidgetsMenu::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == m_menu)
+    {
+        switch (event->type())
+        {
+        case QEvent::ActionAdded:
+        case QEvent::ActionChanged:
+        case QEvent::ActionRemoved:
+            schedulePrelayout();
+            break;
+        default:
+            break;
+        }
+    }
+
+    return PlatformAgnosticMenu::eventFilter(watched, event);
+}
+
+void WidgetsMenu::schedulePrelayout()
+{
+    // Several changes in a row are laid out once
+    if (m_prelayoutPending)
+        return;
+
+    m_prelayoutPending = true;
+    QMetaObject::invokeMethod(this, &WidgetsMenu::prelayout, Qt::QueuedConnection);
+}
+
+void WidgetsMenu::prelayout()
+{
+    m_prelayoutPending = false;
+
+    if (!m_fastPopup || !m_menu || m_menu->isVisible() || isHibernated())
+        return;
+
+    // QMenu caches the geometry of the actions until they change
+    materializePendingActions();
+    updatePage();
+    m_menu->ensurePolished();
+    m_menu->sizeHint();
+}
+
+void WidgetsMenu::setPageSize(const int size)
+{
+    assert(m_menu);
+
+    const bool paging = pageSize() > 0;
+    PlatformAgnosticMenu::setPageSize(size);
+
+    if (size > 0 && !paging)
+        startPaging();
+    else if (size == 0 && paging)
+        stopPaging();
+    else if (size > 0)
+        updatePage();
+}
+
+QList<QAction *> WidgetsMenu::nativeContent() const
+{
+    assert(m_menu);
+
+    if (pageSize() == 0)
+        return m_menu->actions();
+
+    QList<QAction*> list;
+    list.reserve(m_pagedActions.size());
+
+    for (const auto& action : m_pagedActions)
+    {
+        if (action)
+            list.push_back(action);
+    }
+
+    return list;
+}
+
+void WidgetsMenu::addNative(QAction *action)
+{
+    assert(m_menu);
+
+    if (pageSize() == 0)
+    {
+        m_menu->addAction(action);
+        return;
+    }
+
+    m_pagedActions.push_back(action);
+    trackPagedAction(action);
+    schedulePageUpdate();
+}
+
+void WidgetsMenu::insertNative(QAction *before, QAction *action)
+{
+    assert(m_menu);
+
+    if (pageSize() == 0)
+    {
+        m_menu->insertAction(before, action);
+        return;
+    }
+
+    // Moves an action that is already in the menu, as QMenu::insertAction()
+    if (!m_pagedActions.removeOne(action))
+        trackPagedAction(action);
+    const qsizetype index = m_pagedActions.indexOf(before);
+    m_pagedActions.insert(index < 0 ? m_pagedActions.size() : index, action);
+    schedulePageUpdate();
+}
+
+void WidgetsMenu::removeNative(QAction *action)
+{
+    assert(m_menu);
+
+    // Leaves the current page right away
+    m_menu->removeAction(action);
+
+    if (pageSize() > 0)
+    {
+        if (m_pagedActions.removeOne(action))
+            untrackPagedAction(action);
+        schedulePageUpdate();
+    }
+}
+
+void WidgetsMenu::clearNative()
+{
+    assert(m_menu);
+
+    m_separators.clear();
+
+    if (pageSize() == 0)
+    {
+        m_menu->clear();
+        return;
+    }
+
+    const auto actionList = nativeContent();
+    m_pagedActions.clear();
+
+    const auto page = m_menu->actions();
+    for (const auto action : page)
+        m_menu->removeAction(action);
+
+    // As QMenu::clear(), deletes the separators owned by the menu
+    for (const auto action : actionList)
+    {
+        untrackPagedAction(action);
+        if (action->parent() == m_menu)
+            delete action;
+    }
+
+    m_pageStart = 0;
+}
+
+void WidgetsMenu::startPaging()
+{
+    assert(m_menu);
+
+    if (!m_previousPage)
+        m_previousPage = createPageAction(Qt::UpArrow, tr("Previous"), &WidgetsMenu::showPreviousPage);
+    if (!m_nextPage)
+        m_nextPage = createPageAction(Qt::DownArrow, tr("More…"), &WidgetsMenu::showNextPage);
+
+    const auto actionList = m_menu->actions();
+
+    m_pagedActions.reserve(actionList.size());
+    for (const auto action : actionList)
+    {
+        m_menu->removeAction(action);
+        m_pagedActions.push_back(action);
+        trackPagedAction(action);
+    }
+
+    m_pageStart = 0;
+    updatePage();
+}
+
+void WidgetsMenu::stopPaging()
+{
+    assert(m_menu);
+
+    QList<QAction*> actionList;
+    actionList.reserve(m_pagedActions.size());
+
+    for (const auto& action : std::as_const(m_pagedActions))
+    {
+        if (action)
+        {
+            actionList.push_back(action);
+            untrackPagedAction(action);
+        }
+    }
+
+    m_pagedActions.clear();
+
+    const auto page = m_menu->actions();
+    for (const auto action : page)
+        m_menu->removeAction(action);
+
+    m_menu->addActions(actionList);
+}
+
+void WidgetsMenu::trackPagedAction(QAction *action)
+{
+    if (action->isSeparator())
+        return;
+
+    // Off the page the action is not in the native menu, which then neither
+    // relays its triggered() nor takes its shortcut from the window
+    connect(action, &QAction::triggered, this, [this, action]() {
+        if (!m_menu || m_menu->actions().contains(action))
+            return;
+
+        if (const auto platformAgnosticAction = action->property("platformAgnosticAction").value<PlatformAgnosticAction*>())
+            emit triggered(platformAgnosticAction);
+    });
+
+    connect(action, &QAction::changed, this, [this, action]() { keepShortcut(action); });
+    keepShortcut(action);
+}
+
+void WidgetsMenu::untrackPagedAction(QAction *action)
+{
+    disconnect(action, nullptr, this, nullptr);
+
+    if (const auto window = m_shortcutWindows.take(action))
+        window->removeAction(action);
+}
+
+void WidgetsMenu::keepShortcut(QAction *action)
+{
+    if (!m_menu || action->shortcut().isEmpty() || m_shortcutWindows.contains(action))
+        return;
+
+    // The window QMenu takes the shortcuts from: the one of the widget its menu
+    // action is in, such as a menu bar, going up through the parent menus
+    QWidget* window = nullptr;
+    QList<QObject*> objects = m_menu->menuAction()->associatedObjects();
+    for (qsizetype i = 0; i < objects.size() && !window; ++i)
+    {
+        if (const auto menu = qobject_cast<QMenu*>(objects.at(i)))
+            objects.append(menu->menuAction()->associatedObjects());
+        else if (const auto widget = qobject_cast<QWidget*>(objects.at(i)))
+            window = widget->window();
+    }
+
+    // The actions the application added to the window are left alone
+    if (!window || action->associatedObjects().contains(window))
+        return;
+
+    window->addAction(action);
+    m_shortcutWindows.insert(action, window);
+    connect(action, &QObject::destroyed, this, [this, action]() { m_shortcutWindows.remove(action); });
+}
+
+QWidgetAction* WidgetsMenu::createPageAction(const Qt::ArrowType arrow, const QString &text, void (WidgetsMenu::*slot)())
+{
+    const auto button = new QToolButton;
+    button->setArrowType(arrow);
+    button->setText(text);
+    button->setToolButtonStyle(Qt::ToolButtonTextBesideIcon);
+    button->setAutoRaise(true);
+    button->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+
+    // Queued, the page change removes the button from the menu
+    connect(button, &QToolButton::clicked, this, slot, Qt::QueuedConnection);
+
+    // Unlike a plain action, a click on the widget does not close the menu
+    const auto action = new QWidgetAction(this);
+    action->setDefaultWidget(button);
+    return action;
+}
+
+void WidgetsMenu::schedulePageUpdate()
+{
+    // Adding thousands of actions updates the page once
+    if (m_pageUpdatePending)
+        return;
+
+    m_pageUpdatePending = true;
+    QMetaObject::invokeMethod(this, &WidgetsMenu::updatePage, Qt::QueuedConnection);
+}
+
+void WidgetsMenu::updatePage()
+{
+    m_pageUpdatePending = false;
+
+    if (pageSize() == 0 || !m_menu)
+        return;
+
+    m_pagedActions.removeIf([](const QPointer<QAction>& action) { return !action; });
+
+    const qsizetype count = m_pagedActions.size();
+    m_pageStart = std::clamp<qsizetype>(m_pageStart, 0, count);
+
+    QList<QAction*> page;
+    page.reserve(pageSize() + 2);
+
+    // Hidden actions are left out, QMenu would not show them anyway
+    const auto fillPage = [&]() {
+        page.clear();
+        qsizetype index = m_pageStart;
+        for (int visible = 0; index < count && visible < pageSize(); ++index)
+        {
+            QAction* const action = m_pagedActions.at(index);
+            if (action->isVisible())
+            {
+                page.push_back(action);
+                ++visible;
+            }
+        }
+        m_pageEnd = index;
+    };
+
+    fillPage();
+
+    // The actions of the page were removed or hidden
+    if (page.isEmpty() && m_pageStart > 0)
+    {
+        m_pageStart = previousPageStart();
+        fillPage();
+    }
+
+    const auto isVisible = [](const QPointer<QAction>& action) { return action->isVisible(); };
+
+    if (std::any_of(m_pagedActions.cbegin(), m_pagedActions.cbegin() + m_pageStart, isVisible))
+        page.prepend(m_previousPage);
+
+    if (std::any_of(m_pagedActions.cbegin() + m_pageEnd, m_pagedActions.cend(), isVisible))
+        page.push_back(m_nextPage);
+
+    const auto current = m_menu->actions();
+    if (current == page)
+        return;
+
+    // QMenu only lays out the actions of the page
+    for (const auto action : current)
+        m_menu->removeAction(action);
+
+    m_menu->addActions(page);
+}
+
+qsizetype WidgetsMenu::previousPageStart() const
+{
+    qsizetype index = m_pageStart;
+
+    for (int visible = 0; index > 0 && visible < pageSize(); )
+    {
+        --index;
+        if (const auto& action = m_pagedActions.at(index); action && action->isVisible())
+            ++visible;
+    }
+
+    return index;
+}
+
+void WidgetsMenu::showPreviousPage()
+{
+    m_pageStart = previousPageStart();
+    updatePage();
+}
+
+void WidgetsMenu::showNextPage()
+{
+    m_pageStart = m_pageEnd;
+    updatePage();
+}
+
+void WidgetsMenu::addItem(QObject *item)
+{
+    assert(m_menu);
+    assert(qobject_cast<QWidgetAction*>(item));
+
+    materializePendingActions();
+
+    addNative(static_cast<QWidgetAction*>(item));
+}
+
+void WidgetsMenu::removeItem(QObject *item)
+{
+    assert(m_menu);
+    assert(qobject_cast<QWidgetAction*>(item));
+
+    if (removePendingItem(item))
+        return;
+
+    removeNative(static_cast<QWidgetAction*>(item));
+}
+
+PlatformAgnosticAccounting::Usage WidgetsMenu::usage() const
+{
+    auto usage = PlatformAgnosticMenu::usage();
+    usage.backend = static_cast<int>(Backend::Widgets);
+    usage.bytes += sizeof(WidgetsMenu) - sizeof(PlatformAgnosticMenu)
+                   + (m_pagedActions.capacity() + m_separators.capacity()) * sizeof(QPointer<QAction>)
+                   + m_shortcutWindows.capacity() * (sizeof(QAction*) + sizeof(QPointer<QWidget>));
+
+    if (m_menu)
+    {
+        // The separators are owned by the menu, the other actions by their wrappers
+        usage.separators = int(std::count_if(m_separators.cbegin(), m_separators.cend(), [](const QPointer<QAction>& separator) {
+            return !separator.isNull();
+        }));
+        usage.nativeObjects = 1 + usage.separators;
+    }
+
+    usage.nativeObjects += int(!!m_previousPage) + int(!!m_nextPage);
+    return usage;
+}
+
+QObject* WidgetsMenu::menu() const
+{
+    return m_menu.data();
+}
+
+void WidgetsMenu::setMenu(QObject *menu)
+{
+    assert(menu);
+    assert(qobject_cast<QMenu*>(menu));
+
+    const bool fastPopup = m_fastPopup;
+    if (fastPopup && m_menu)
+        setFastPopup(false);
+    m_fastPopup = false;
+
+    // The paged actions go back to the previous menu
+    const int pagedSize = pageSize();
+    if (pagedSize > 0)
+        setPageSize(0);
+
+    // The menu created by the constructor is replaced
+    if (m_menu && m_menu != menu)
+        delete m_menu.data();
+
+    m_menu = static_cast<QMenu*>(menu);
+    connectMenu();
+    updateEventTargets();
+
+    // The menu may already have content when it is wrapped
+    clearPendingActions();
+    resetActions(nativeActions());
+
+    setFastPopup(fastPopup);
+    setPageSize(pagedSize);
+}
+
+WidgetsAction::WidgetsAction(QObject *parent, const bool lazy)
+    : PlatformAgnosticAction{parent}
+{
+    if (lazy)
+        m_lazyState.reset(new LazyState{{}, {}, {}, {}, {}, true, false, false, true});
+    else
+        createNativeAction();
+}
+
+void WidgetsAction::createNativeAction()
+{
+    assert(!m_action);
+
+    // A child of the wrapper, so that it does not outlive it
+    const auto action = new QAction(this);
+    m_action = action;
+    m_ownsNativeAction = true;
+
+    connect(action, &QAction::changed, this, &WidgetsAction::updateVisibility);
+
+    m_action->setProperty("platformAgnosticAction", QVariant::fromValue(this));
+}
+
+void WidgetsAction::destroyNativeAction(LazyState &state)
+{
+    assert(m_action);
+
+    // QIcon does not know where it was loaded from
+    state.icon = m_action->property("platformAgnosticIcon").toString();
+    state.iconIsSource = m_action->property("platformAgnosticIconIsSource").toBool();
+
+    delete m_action.data();
+}
+
+void WidgetsAction::connectNativeSignals()
+{
+    assert(m_action);
+
+    connect(m_action.data(), &QAction::toggled, this, &PlatformAgnosticAction::toggled, Qt::UniqueConnection);
+    connect(m_action.data(), &QAction::triggered, this, &PlatformAgnosticAction::triggered, Qt::UniqueConnection);
+}
+
+void WidgetsAction::updateVisibility()
+{
+    assert(m_action);
+    m_action->setVisible(!m_action->text().isEmpty() && !m_filteredOut);
+}
+
+void WidgetsAction::setFilteredOut(const bool filteredOut)
+{
+    m_filteredOut = filteredOut;
+    if (m_action)
+        updateVisibility();
+}
+
+void WidgetsAction::setShortcut(const QKeySequence &shortcut)
+{
+    PLATFORMAGNOSTIC_TRACE(ActionSetShortcut, this, shortcut);
+
+    if (m_lazyState)
+    {
+        if (shortcut.isEmpty())
+        {
+            m_lazyState->shortcut = shortcut;
+            return;
+        }
+
+        // The shortcut has to work before the menu is first shown
+        materializeInMenus();
+    }
+
+    assert(m_action);
+    m_action->setShortcut(shortcut);
+}
+
+void WidgetsAction::setActionGroup(PlatformAgnosticActionGroup *actionGroup)
+{
+    PLATFORMAGNOSTIC_TRACE(ActionSetActionGroup, this, actionGroup);
+
+    assert(actionGroup ? !!qobject_cast<WidgetsActionGroup*>(actionGroup) : true);
+
+    joinActionGroup(actionGroup);
+
+    if (m_lazyState)
+    {
+        m_lazyState->actionGroup = actionGroup;
+        return;
+    }
+
+    assert(m_action);
+
+    m_action->setActionGroup(actionGroup ? static_cast<WidgetsActionGroup*>(actionGroup)->m_actionGroup.data()
+                                         : nullptr);
+}
+
+void WidgetsAction::setIcon(const QString &iconSourceOrName, const bool isSource)
+{
+    PLATFORMAGNOSTIC_TRACE(ActionSetIcon, this, iconSourceOrName, isSource);
+
+    if (m_lazyState)
+    {
+        m_lazyState->icon = iconSourceOrName;
+        m_lazyState->iconIsSource = isSource;
+        return;
+    }
+
+    assert(m_action);
+
+    QIcon icon;
+    if (isSource)
+    {
+        icon = QIcon(iconSourceOrName);
+    }
+    else
+    {
+        assert(QIcon::hasThemeIcon(iconSourceOrName));
+        icon = QIcon::fromTheme(iconSourceOrName);
+    }
+    assert(!icon.isNull());
+
+    m_action->setIcon(icon);
+
+    // For destroyNativeAction()
+    m_action->setProperty("platformAgnosticIcon", iconSourceOrName);
+    m_action->setProperty("platformAgnosticIconIsSource", isSource);
+}
+
+PlatformAgnosticAccounting::Usage WidgetsAction::usage() const
+{
+    auto usage = PlatformAgnosticAction::usage();
+    usage.backend = static_cast<int>(PlatformAgnosticMenu::Backend::Widgets);
+    usage.bytes += sizeof(WidgetsAction) - sizeof(PlatformAgnosticAction);
+    usage.nativeObjects = (m_ownsNativeAction && m_action) ? 1 : 0;
+    return usage;
+}
+
+QObject *WidgetsAction::action() const
+{
+    return m_action.data();
+}
+
+void WidgetsAction::setAction(QObject *action)
+{
+    assert(action);
+    assert(qobject_cast<QAction*>(action));
+
+    // Replaces the native action or the lazy state the wrapper was created with
+    if (m_ownsNativeAction)
+        delete m_action.data();
+    m_lazyState.reset();
+
+    m_action = static_cast<QAction*>(action);
+    m_ownsNativeAction = false;
+}
+
+WidgetsActionGroup::WidgetsActionGroup(QObject *parent)
+    : PlatformAgnosticActionGroup{parent}
+{
+    // A child of the wrapper, so that it does not outlive it
+    m_actionGroup = new QActionGroup(this);
+    connect(m_actionGroup.data(), &QActionGroup::triggered, this, &PlatformAgnosticActionGroup::triggered);
+
+    m_actionGroup->setProperty("agnosticActionGroup", QVariant::fromValue(this));
+}
+
+PlatformAgnosticAction* WidgetsActionGroup::checkedAction() const
+{
+    assert(m_actionGroup);
+
+    // QActionGroup keeps the checked action itself
+    if (const auto action = m_actionGroup->checkedAction())
+        return action->property("platformAgnosticAction").value<PlatformAgnosticAction*>();
+
+    return nullptr;
+}
+
+PlatformAgnosticAccounting::Usage WidgetsActionGroup::usage() const
+{
+    auto usage = PlatformAgnosticActionGroup::usage();
+    usage.backend = static_cast<int>(PlatformAgnosticMenu::Backend::Widgets);
+    usage.bytes += sizeof(WidgetsActionGroup) - sizeof(PlatformAgnosticActionGroup);
+    usage.nativeObjects = (m_actionGroup && m_actionGroup->parent() == this) ? 1 : 0;
+    return usage;
+}
+
+QObject* WidgetsActionGroup::actionGroup() const
+{
+    return m_actionGroup.data();
+}
+
+void WidgetsActionGroup::setActionGroup(QObject *actionGroup)
+{
+    assert(actionGroup);
+    assert(qobject_cast<QActionGroup*>(actionGroup));
+
+    // The group created by the constructor is replaced
+    if (m_actionGroup && m_actionGroup->parent() == this)
+        delete m_actionGroup.data();
+
+    m_actionGroup = static_cast<QActionGroup*>(actionGroup);
+
+    // The group may already have members when it is wrapped
+    QList<PlatformAgnosticAction*> actionList;
+    const auto nativeActions = m_actionGroup->actions();
+    for (const auto action : nativeActions)
+    {
+        if (const auto platformAgnosticAction = action->property("platformAgnosticAction").value<PlatformAgnosticAction*>())
+            actionList.push_back(platformAgnosticAction);
+    }
+
+    adoptActions(actionList);
+}
@@ -0,0 +1,194 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef PLATFORMAGNOSTICWIDGETS_HPP
+#define PLATFORMAGNOSTICWIDGETS_HPP
+
+#include <QPointer>
+#include <QHash>
+
+#include "platformagnosticmenu.hpp"
+#include "platformagnosticaction.hpp"
+#include "platformagnosticactiongroup.hpp"
+#include "platformagnosticbackend.hpp"
+
+class WidgetsMenu final : public PlatformAgnosticMenu
+{
+    Q_OBJECT
+
+public:
+    explicit WidgetsMenu(WidgetsMenu* parent = nullptr);
+    virtual ~WidgetsMenu();
+
+    // Returns nullptr for a parent of another backend
+    static PlatformAgnosticMenu* create(QObject* parent);
+
+    void insertAction(PlatformAgnosticAction *before, PlatformAgnosticAction *action) override;
+
+    void clear() override;
+
+    void addAction(PlatformAgnosticAction *action) override;
+    void removeAction(PlatformAgnosticAction *action) override;
+
+    void addMenu(PlatformAgnosticMenu *menu) override;
+
+    void popup(const QPoint& pos) override;
+
+    void close() override;
+
+    void addSeparator() override;
+
+    QSize sizeHint() const override;
+
+    void batchUpdates(const std::function<void()>& updates) override;
+
+    void setTearOffEnabled(bool enabled) override;
+    void setFastPopup(bool enabled) override;
+    void setPageSize(int size) override;
+
+    void addItem(QObject* item) override;
+    void removeItem(QObject* item) override;
+
+    PlatformAgnosticAccounting::Usage usage() const override;
+
+protected:
+    QObject* menu() const override;
+    void setMenu(QObject * menu) override;
+    void addNativeAction(PlatformAgnosticAction* action) override;
+    void addNativeSeparator() override;
+    void addNativeItem(QObject* item) override;
+    QList<PendingEntry> takeNativeContent() override;
+    void applyFilter(const QList<PlatformAgnosticAction*>& filteredOut,
+                     const QList<PlatformAgnosticAction*>& filteredIn) override;
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+    QList<PlatformAgnosticAction*> nativeActions() const;
+    void connectMenu();
+    void schedulePrelayout();
+    void prelayout();
+
+    // Change the content of the native menu, or only the paged actions while paging
+    QList<class QAction*> nativeContent() const;
+    void addNative(QAction* action);
+    void insertNative(QAction* before, QAction* action);
+    void removeNative(QAction* action);
+    void clearNative();
+
+    void startPaging();
+    void stopPaging();
+    void trackPagedAction(QAction* action);
+    void untrackPagedAction(QAction* action);
+    void keepShortcut(QAction* action);
+    class QWidgetAction* createPageAction(Qt::ArrowType arrow, const QString& text, void (WidgetsMenu::*slot)());
+    void schedulePageUpdate();
+    void updatePage();
+    qsizetype previousPageStart() const;
+    void showPreviousPage();
+    void showNextPage();
+
+    QPointer<class QMenu> m_menu;
+
+    bool m_fastPopup = false;
+    bool m_prelayoutPending = false;
+
+    // Created by addNativeSeparator(), the only native actions deleted by hibernate()
+    QList<QPointer<QAction>> m_separators;
+
+    // All the native actions while paging, the native menu only has those of the page
+    QList<QPointer<QAction>> m_pagedActions;
+    QPointer<QWidgetAction> m_previousPage;
+    QPointer<QWidgetAction> m_nextPage;
+    qsizetype m_pageStart = 0;
+    qsizetype m_pageEnd = 0;
+    bool m_pageUpdatePending = false;
+
+    // The paged actions with a shortcut, and the windows they were added to for it
+    QHash<QAction*, QPointer<class QWidget>> m_shortcutWindows;
+};
+
+class WidgetsAction final : public PlatformAgnosticAction
+{
+    Q_OBJECT
+
+    friend class WidgetsActionGroup;
+    friend class WidgetsMenu;
+
+public:
+    WidgetsAction(QObject *parent = nullptr, bool lazy = false);
+    virtual ~WidgetsAction() = default;
+
+    // Returns nullptr for a parent of another backend
+    static PlatformAgnosticAction* create(QObject* parent, bool lazy);
+
+    void setShortcut(const QKeySequence &shortcut) override;
+    void setActionGroup(PlatformAgnosticActionGroup* actionGroup) override;
+    void setIcon(const QString& iconSourceOrName, bool isSource = true) override;
+
+    PlatformAgnosticAccounting::Usage usage() const override;
+
+protected:
+    QObject* action() const override;
+    void setAction(QObject* action) override;
+    void createNativeAction() override;
+    void connectNativeSignals() override;
+    void destroyNativeAction(LazyState& state) override;
+    void setFilteredOut(bool filteredOut) override;
+
+private:
+    void updateVisibility();
+
+    QPointer<class QAction> m_action;
+};
+
+class WidgetsActionGroup final : public PlatformAgnosticActionGroup
+{
+    Q_OBJECT
+
+    friend class WidgetsAction;
+
+public:
+    explicit WidgetsActionGroup(QObject* parent = nullptr);
+    virtual ~WidgetsActionGroup() = default;
+
+    // Returns nullptr for a parent of another backend
+    static PlatformAgnosticActionGroup* create(QObject* parent);
+
+    PlatformAgnosticAction* checkedAction() const override;
+
+    PlatformAgnosticAccounting::Usage usage() const override;
+
+protected:
+    QObject* actionGroup() const override;
+    void setActionGroup(QObject* actionGroup) override;
+
+private:
+    QPointer<class QActionGroup> m_actionGroup;
+};
+
+namespace PlatformAgnosticBackend
+{
+    // Called during static initialization by platformagnosticwidgetsregistration.cpp
+    bool registerWidgets();
+}
+
+#endif // PLATFORMAGNOSTICWIDGETS_HPP
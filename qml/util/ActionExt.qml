@@ -26,5 +26,6 @@ import QtQuick 2.12
 import QtQuick.Controls 2.12
 
 Action {
-
+    // Set while the action is hidden by the filter of its menu
+    property bool _filteredOut: false
 }
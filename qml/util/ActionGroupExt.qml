@@ -22,24 +22,9 @@
  * SOFTWARE.
  *
  */
-import QtQml 2.12
 import QtQuick 2.12
 import QtQuick.Controls 2.12
 
 ActionGroup {
-    signal _triggered(QtObject action)
 
-    function _addAction(action /* : QtObject */) {
-        console.assert(action instanceof Action)
-        addAction(action)
-    }
-
-    function _removeAction(action /* : QtObject */) {
-        console.assert(action instanceof Action)
-        removeAction(action)
-    }
-
-    onTriggered: function(action) {
-        _triggered(action)
-    }
 }
@@ -28,22 +28,25 @@ import QtQuick.Controls 2.12
 Menu {
     id: control
 
-    contentItem.focus: true
-
-    delegate: MenuItem { visible: (text.length > 0) }
-
-    function _addMenu(menu /* : QtObject */) {
-        console.assert(menu instanceof Menu)
-        addMenu(menu)
-    }
+    // Relayed to PlatformAgnosticMenu::hovered(), a single connection per menu
+    // rather than one per action. triggered() is relayed by the actions, so that
+    // it is also emitted for shortcuts and Action.trigger().
+    signal _hovered(QtObject action)
+    // Lets the submenu be built while the pointer rests on its entry
+    signal _subMenuHovered(QtObject subMenu)
 
-    function _addAction(action /* : QtObject */) {
-        console.assert(action instanceof Action)
-        addAction(action)
-    }
+    contentItem.focus: true
 
-    function _removeAction(action /* : QtObject */) {
-        console.assert(action instanceof Action)
-        removeAction(action)
+    delegate: MenuItem {
+        visible: (text.length > 0) && !(action && action._filteredOut)
+        height: visible ? implicitHeight : 0
+        onHoveredChanged: {
+            if (!hovered)
+                return
+            if (subMenu)
+                control._subMenuHovered(subMenu)
+            else
+                control._hovered(action)
+        }
     }
 }
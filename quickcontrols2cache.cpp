@@ -0,0 +1,203 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "quickcontrols2cache.hpp"
+
+#include <QHash>
+#include <QPointer>
+#include <QQmlComponent>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QQmlListReference>
+#include <QQuickItem>
+#include <QQuickWindow>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <utility>
+
+// Overridden by the build system when the QML files are part of a QML module
+#ifndef PLATFORMAGNOSTICMENUS_QML_ROOT
+#define PLATFORMAGNOSTICMENUS_QML_ROOT "qrc:///"
+#endif
+
+#define QQUICKCONTROLS2_MENU_PATH PLATFORMAGNOSTICMENUS_QML_ROOT "widgets/MenuExt.qml"
+#define QQUICKCONTROLS2_MENU_SEPARATOR_PATH PLATFORMAGNOSTICMENUS_QML_ROOT "widgets/MenuSeparatorExt.qml"
+#define QQUICKCONTROLS2_ACTION_PATH PLATFORMAGNOSTICMENUS_QML_ROOT "util/ActionExt.qml"
+#define QQUICKCONTROLS2_ACTION_GROUP_PATH PLATFORMAGNOSTICMENUS_QML_ROOT "util/ActionGroupExt.qml"
+
+namespace
+{
+
+using Components = std::array<QPointer<QQmlComponent>, 4>;
+
+// Only accessed from the GUI thread
+QHash<QObject*, QPointer<QQmlEngine>> s_engines;
+QHash<QQmlEngine*, Components> s_components;
+
+QObject* rootOf(QObject* object)
+{
+    // Qt Quick objects created by the wrappers are not items, but they are
+    // parented to a wrapper which is eventually parented to an item or a window
+    for (QObject* i = object; i; i = i->parent())
+    {
+        if (const auto item = qobject_cast<QQuickItem*>(i))
+        {
+            if (const auto window = item->window())
+                return window;
+
+            QQuickItem* rootItem = item;
+            while (rootItem->parentItem())
+                rootItem = rootItem->parentItem();
+            return rootItem;
+        }
+        else if (qobject_cast<QQuickWindow*>(i))
+        {
+            return i;
+        }
+    }
+
+    return object;
+}
+
+QQmlEngine* probeEngine(QObject* quickParent)
+{
+    // In normal cases, quickParent should have a valid qml engine associated to its context:
+    if (const auto engine = qmlEngine(quickParent))
+        return engine;
+
+    // Sometimes QQuickRootItem does not have an engine associated to its context
+    // In these cases, the engine is probed using its first QQuickItem child.
+    QObject* item = quickParent;
+    if (const auto window = qobject_cast<QQuickWindow*>(quickParent))
+        item = window->contentItem();
+
+    if (qobject_cast<QQuickItem*>(item))
+    {
+        const auto children = QQmlListReference(item, "children");
+        if (children.count() > 0)
+            return qmlEngine(children.at(0));
+    }
+
+    return nullptr;
+}
+
+const char* pathOf(const QuickControls2Cache::Component component)
+{
+    switch (component)
+    {
+    case QuickControls2Cache::Component::Menu:
+        return QQUICKCONTROLS2_MENU_PATH;
+    case QuickControls2Cache::Component::MenuSeparator:
+        return QQUICKCONTROLS2_MENU_SEPARATOR_PATH;
+    case QuickControls2Cache::Component::Action:
+        return QQUICKCONTROLS2_ACTION_PATH;
+    case QuickControls2Cache::Component::ActionGroup:
+        return QQUICKCONTROLS2_ACTION_GROUP_PATH;
+    }
+
+    Q_UNREACHABLE();
+}
+
+}
+
+QuickControls2Cache::Resolution QuickControls2Cache::resolve(QObject *quickParent)
+{
+    assert(quickParent);
+
+    QObject* const root = rootOf(quickParent);
+
+    QQmlEngine* engine = s_engines.value(root);
+    if (!engine)
+    {
+        engine = probeEngine(quickParent);
+        if (!engine && root != quickParent)
+            engine = probeEngine(root);
+
+        assert(engine);
+
+        if (!s_engines.contains(root))
+        {
+            QObject::connect(root, &QObject::destroyed, [root]() {
+                s_engines.remove(root);
+            });
+        }
+
+        s_engines.insert(root, engine);
+    }
+
+    // Not cached, the objects are created in the context of their own parent
+    QQmlContext* context = qmlContext(quickParent);
+    if (!context)
+        context = engine->rootContext();
+
+    return {engine, context};
+}
+
+QQmlComponent *QuickControls2Cache::component(QQmlEngine *engine, const Component component)
+{
+    assert(engine);
+
+    auto it = s_components.find(engine);
+    if (it == s_components.end())
+    {
+        QObject::connect(engine, &QObject::destroyed, [engine]() {
+            s_components.remove(engine);
+        });
+
+        it = s_components.insert(engine, {});
+    }
+
+    auto& cached = (*it)[static_cast<size_t>(component)];
+    if (!cached)
+    {
+        // Owned by the engine, the components can not outlive it anyway
+        cached = new QQmlComponent(engine, QUrl(QString::fromLatin1(pathOf(component))), engine);
+    }
+
+    return cached;
+}
+
+QObject *QuickControls2Cache::create(QObject *quickParent, const Component component)
+{
+    const auto resolution = resolve(quickParent);
+
+    QObject* const object = QuickControls2Cache::component(resolution.engine, component)->create(resolution.context);
+    assert(object);
+
+    QQmlEngine::setObjectOwnership(object, QQmlEngine::CppOwnership);
+
+    return object;
+}
+
+qint64 QuickControls2Cache::componentCount()
+{
+    qint64 count = 0;
+
+    for (const auto& components : std::as_const(s_components))
+        count += std::count_if(components.cbegin(), components.cend(), [](const QPointer<QQmlComponent>& component) {
+            return !component.isNull();
+        });
+
+    return count;
+}
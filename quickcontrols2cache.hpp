@@ -0,0 +1,62 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef QUICKCONTROLS2CACHE_HPP
+#define QUICKCONTROLS2CACHE_HPP
+
+#include <QtGlobal>
+
+class QObject;
+class QQmlEngine;
+class QQmlContext;
+class QQmlComponent;
+
+// Resolves the engine to create the Qt Quick objects with once per window or
+// root item, and the context for each object. The components are shared per engine.
+namespace QuickControls2Cache
+{
+    enum class Component
+    {
+        Menu,
+        MenuSeparator,
+        Action,
+        ActionGroup
+    };
+
+    struct Resolution
+    {
+        QQmlEngine* engine = nullptr;
+        QQmlContext* context = nullptr;
+    };
+
+    Resolution resolve(QObject* quickParent);
+
+    QQmlComponent* component(QQmlEngine* engine, Component component);
+
+    // Shorthand for component(resolve(quickParent).engine, component)->create(context)
+    QObject* create(QObject* quickParent, Component component);
+
+    // The number of components loaded over all engines, for PlatformAgnosticAccounting
+    qint64 componentCount();
+}
+
+#endif // QUICKCONTROLS2CACHE_HPP
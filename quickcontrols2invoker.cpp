@@ -0,0 +1,210 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "quickcontrols2invoker.hpp"
+
+#include <QObject>
+#include <QMetaMethod>
+#include <QMetaProperty>
+#include <QPointF>
+
+#include <cassert>
+
+namespace
+{
+
+class CachedMethod
+{
+public:
+    CachedMethod(const char* className, const char* signature)
+        : m_className{className}
+        , m_signature{signature}
+    {
+
+    }
+
+    const QMetaMethod& get(const QObject* object)
+    {
+        if (m_method.isValid())
+            return m_method;
+
+        // Types declared in QML have their own meta objects, so look up
+        // the C++ class which declares the invokable. Its method index is
+        // valid for every type derived from it.
+        const QMetaObject* metaObject = object->metaObject();
+        while (metaObject && qstrcmp(metaObject->className(), m_className) != 0)
+            metaObject = metaObject->superClass();
+
+        assert(metaObject);
+
+        const int index = metaObject->indexOfMethod(m_signature);
+        assert(index >= 0);
+
+        m_method = metaObject->method(index);
+        return m_method;
+    }
+
+private:
+    const char* const m_className;
+    const char* const m_signature;
+    QMetaMethod m_method;
+};
+
+class CachedProperty
+{
+public:
+    CachedProperty(const char* className, const char* name)
+        : m_className{className}
+        , m_name{name}
+    {
+
+    }
+
+    const QMetaProperty& get(const QObject* object)
+    {
+        if (m_property.isValid())
+            return m_property;
+
+        // See CachedMethod::get()
+        const QMetaObject* metaObject = object->metaObject();
+        while (metaObject && qstrcmp(metaObject->className(), m_className) != 0)
+            metaObject = metaObject->superClass();
+
+        assert(metaObject);
+
+        const int index = metaObject->indexOfProperty(m_name);
+        assert(index >= 0);
+
+        m_property = metaObject->property(index);
+        return m_property;
+    }
+
+private:
+    const char* const m_className;
+    const char* const m_name;
+    QMetaProperty m_property;
+};
+
+CachedProperty s_popupX{"QQuickPopup", "x"};
+CachedProperty s_popupY{"QQuickPopup", "y"};
+CachedMethod s_popupOpen{"QQuickPopup", "open()"};
+CachedMethod s_menuAddAction{"QQuickMenu", "addAction(QQuickAction*)"};
+CachedMethod s_menuInsertAction{"QQuickMenu", "insertAction(int,QQuickAction*)"};
+CachedMethod s_menuRemoveAction{"QQuickMenu", "removeAction(QQuickAction*)"};
+CachedMethod s_menuAddMenu{"QQuickMenu", "addMenu(QQuickMenu*)"};
+CachedMethod s_menuAddItem{"QQuickMenu", "addItem(QQuickItem*)"};
+CachedMethod s_menuRemoveItem{"QQuickMenu", "removeItem(QQuickItem*)"};
+CachedMethod s_menuTakeItem{"QQuickMenu", "takeItem(int)"};
+CachedMethod s_actionGroupAddAction{"QQuickActionGroup", "addAction(QQuickAction*)"};
+CachedMethod s_actionGroupRemoveAction{"QQuickActionGroup", "removeAction(QQuickAction*)"};
+
+// The private types are not available here, but QObject is the
+// primary base of all of them, so passing the QObject pointer
+// under the name of the declared type is equivalent.
+void invoke(CachedMethod& method, QObject* target, const char* typeName, QObject* argument)
+{
+    assert(target);
+    assert(argument);
+
+    const bool ret = method.get(target).invoke(target,
+                                               Qt::DirectConnection,
+                                               QGenericArgument(typeName, &argument));
+    assert(ret);
+}
+
+}
+
+void QuickControls2Invoker::setPosition(QObject* popup, const QPointF& pos)
+{
+    assert(popup);
+
+    s_popupX.get(popup).write(popup, pos.x());
+    s_popupY.get(popup).write(popup, pos.y());
+}
+
+void QuickControls2Invoker::open(QObject* popup)
+{
+    assert(popup);
+
+    const bool ret = s_popupOpen.get(popup).invoke(popup, Qt::DirectConnection);
+    assert(ret);
+}
+
+void QuickControls2Invoker::addAction(QObject* menu, QObject* action)
+{
+    invoke(s_menuAddAction, menu, "QQuickAction*", action);
+}
+
+void QuickControls2Invoker::insertAction(QObject* menu, int index, QObject* action)
+{
+    assert(menu);
+    assert(action);
+
+    const bool ret = s_menuInsertAction.get(menu).invoke(menu,
+                                                         Qt::DirectConnection,
+                                                         QGenericArgument("int", &index),
+                                                         QGenericArgument("QQuickAction*", &action));
+    assert(ret);
+}
+
+void QuickControls2Invoker::removeAction(QObject* menu, QObject* action)
+{
+    invoke(s_menuRemoveAction, menu, "QQuickAction*", action);
+}
+
+void QuickControls2Invoker::addMenu(QObject* menu, QObject* subMenu)
+{
+    invoke(s_menuAddMenu, menu, "QQuickMenu*", subMenu);
+}
+
+void QuickControls2Invoker::addItem(QObject* menu, QObject* item)
+{
+    invoke(s_menuAddItem, menu, "QQuickItem*", item);
+}
+
+void QuickControls2Invoker::removeItem(QObject* menu, QObject* item)
+{
+    invoke(s_menuRemoveItem, menu, "QQuickItem*", item);
+}
+
+QObject* QuickControls2Invoker::takeItem(QObject* menu, int index)
+{
+    assert(menu);
+
+    QObject* item = nullptr;
+    const bool ret = s_menuTakeItem.get(menu).invoke(menu,
+                                                     Qt::DirectConnection,
+                                                     QGenericReturnArgument("QQuickItem*", &item),
+                                                     QGenericArgument("int", &index));
+    assert(ret);
+    return item;
+}
+
+void QuickControls2Invoker::addGroupAction(QObject* actionGroup, QObject* action)
+{
+    invoke(s_actionGroupAddAction, actionGroup, "QQuickAction*", action);
+}
+
+void QuickControls2Invoker::removeGroupAction(QObject* actionGroup, QObject* action)
+{
+    invoke(s_actionGroupRemoveAction, actionGroup, "QQuickAction*", action);
+}
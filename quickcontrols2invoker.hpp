@@ -0,0 +1,53 @@
+/* MIT License
+ *
+ * Copyright (c) 2023 Fatih Uzunoglu <fuzun54@outlook.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef QUICKCONTROLS2INVOKER_HPP
+#define QUICKCONTROLS2INVOKER_HPP
+
+class QObject;
+class QPointF;
+
+// Calls the invokables of QQuickMenu and QQuickActionGroup from C++.
+// The meta methods and properties are resolved once, and then used
+// directly without going through JavaScript functions or name lookups.
+namespace QuickControls2Invoker
+{
+    // QQuickPopup:
+    void setPosition(QObject* popup, const QPointF& pos);
+    void open(QObject* popup);
+
+    // QQuickMenu:
+    void addAction(QObject* menu, QObject* action);
+    void insertAction(QObject* menu, int index, QObject* action);
+    void removeAction(QObject* menu, QObject* action);
+    void addMenu(QObject* menu, QObject* subMenu);
+    void addItem(QObject* menu, QObject* item);
+    void removeItem(QObject* menu, QObject* item);
+    // Removes the item without destroying it
+    QObject* takeItem(QObject* menu, int index);
+
+    // QQuickActionGroup:
+    void addGroupAction(QObject* actionGroup, QObject* action);
+    void removeGroupAction(QObject* actionGroup, QObject* action);
+}
+
+#endif // QUICKCONTROLS2INVOKER_HPP